@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace memory {
+
+Arena::~Arena()
+{
+    reset();
+}
+
+bool Arena::init(Heap* heap, std::size_t blockSize)
+{
+    reset();
+
+    m_heap = nullptr;
+    m_blockSize = 0;
+
+    if (heap == nullptr || blockSize <= sizeof(BlockHeader))
+        return false;
+
+    m_heap = heap;
+    m_blockSize = blockSize;
+    return true;
+}
+
+void Arena::rollback(const Mark& mark)
+{
+    while (m_block != mark.block) {
+        assert(m_block);
+        releaseBlock();
+    }
+
+    if (m_block != nullptr) {
+        assert(mark.position >= reinterpret_cast<std::uintptr_t>(m_block + 1) && mark.position <= m_end);
+        m_position = mark.position;
+    }
+}
+
+void Arena::reset()
+{
+    while (m_block != nullptr)
+        releaseBlock();
+}
+
+std::size_t Arena::blocksCount() const
+{
+    std::size_t count = 0;
+    for (auto* block = m_block; block != nullptr; block = block->prev)
+        ++count;
+
+    return count;
+}
+
+void* Arena::allocateSlow(std::size_t size, std::size_t alignment)
+{
+    if (size == 0 || m_heap == nullptr)
+        return nullptr;
+
+    // Leftover of the current block is abandoned, because blocks are released only in the reversed order.
+    auto requiredSize = sizeof(BlockHeader) + alignment - 1 + size;
+    if (requiredSize < size)
+        return nullptr;
+
+    auto blockSize = std::max(m_blockSize, requiredSize);
+    auto* memory = m_heap->tryReserve(blockSize);
+    if (memory == nullptr)
+        return nullptr;
+
+    auto* block = new (memory) BlockHeader{m_block, reinterpret_cast<std::uintptr_t>(memory) + blockSize};
+    m_block = block;
+    m_position = reinterpret_cast<std::uintptr_t>(block + 1);
+    m_end = block->end;
+
+    auto* ptr = allocate(size, alignment);
+    assert(ptr);
+    return ptr;
+}
+
+void Arena::releaseBlock()
+{
+    assert(m_block);
+
+    auto* block = m_block;
+    m_block = block->prev;
+    m_position = (m_block != nullptr) ? m_block->end : 0;
+    m_end = m_position;
+    m_heap->release(block);
+}
+
+} // namespace memory
@@ -0,0 +1,386 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Page.hpp"
+#include "PageAllocator.hpp"
+#include "ZoneAllocator.hpp"
+
+#include <allocator/Heap.hpp>
+#include <allocator/Tracer.hpp>
+
+#include <array>
+#include <atomic>
+#include <new>
+
+namespace memory {
+namespace {
+
+/// Scoped guard of the heap lock, that accepts empty lock.
+class LockGuard {
+public:
+    /// Constructor. Acquires the given lock.
+    /// @param lock         Lock to be acquired or nullptr.
+    explicit LockGuard(HeapLock* lock)
+        : m_lock(lock)
+    {
+        if (m_lock != nullptr)
+            m_lock->lock();
+    }
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because LockGuard is not meant to be copy-constructed.
+    LockGuard(const LockGuard&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because LockGuard is not meant to be move-constructed.
+    LockGuard(LockGuard&&) = delete;
+
+    /// Destructor. Releases the lock.
+    ~LockGuard()
+    {
+        if (m_lock != nullptr)
+            m_lock->unlock();
+    }
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because LockGuard is not meant to be copy-assigned.
+    LockGuard& operator=(const LockGuard&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because LockGuard is not meant to be move-assigned.
+    LockGuard& operator=(LockGuard&&) = delete;
+
+private:
+    HeapLock* m_lock; ///< Guarded lock.
+};
+
+} // namespace
+
+/// Internal state of the heap.
+struct Heap::Impl {
+    /// Memory block queued for the deferred release. Link is stored in the block itself.
+    struct DeferredBlock {
+        DeferredBlock* next; ///< Next block queued for the deferred release.
+    };
+
+    PageAllocator pageAllocator;                  ///< Allocator of the pages from the heap regions.
+    ZoneAllocator zoneAllocator;                  ///< Allocator of the small memory blocks from the heap pages.
+    std::atomic<DeferredBlock*> deferredBlocks{}; ///< Lock-free stack of the blocks queued by releaseDeferred().
+    DeferredBlock* drainedBlocks{};               ///< Blocks taken from the stack, that exceeded the drain budget.
+};
+
+Heap::Heap() noexcept
+{
+    static_assert(sizeof(Impl) <= m_cStorageSize, "Heap storage is too small for its internal state");
+    static_assert(alignof(Impl) <= alignof(std::max_align_t), "Heap storage is not aligned for its internal state");
+
+    new (m_storage.data()) Impl();
+}
+
+Heap::~Heap()
+{
+    impl()->~Impl();
+}
+
+bool Heap::init(Region* regions, std::size_t pageSize)
+{
+    LockGuard guard(m_lock);
+
+    impl()->pageAllocator.clear();
+    impl()->zoneAllocator.clear();
+    impl()->deferredBlocks = nullptr;
+    impl()->drainedBlocks = nullptr;
+
+    if (!impl()->pageAllocator.init(regions, pageSize))
+        return false;
+
+    return impl()->zoneAllocator.init(&impl()->pageAllocator, pageSize);
+}
+
+bool Heap::init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize)
+{
+    std::array<Region, 2> regions = {{{start, end - start}, {0, 0}}};
+
+    return init(regions.data(), pageSize);
+}
+
+void Heap::destroy()
+{
+    LockGuard guard(m_lock);
+
+    // All bookkeeping lives either in this object or in the heap regions, so dropping it releases everything.
+    impl()->pageAllocator.clear();
+    impl()->zoneAllocator.clear();
+    impl()->deferredBlocks = nullptr;
+    impl()->drainedBlocks = nullptr;
+}
+
+void Heap::setLock(HeapLock* lock)
+{
+    m_lock = lock;
+}
+
+void Heap::setTracer(Tracer* tracer)
+{
+    m_tracer = tracer;
+}
+
+void Heap::setZonePolicy(ZonePolicy policy)
+{
+    LockGuard guard(m_lock);
+    impl()->zoneAllocator.setPolicy(policy);
+}
+
+void Heap::setZoneColouring(bool enabled)
+{
+    LockGuard guard(m_lock);
+    impl()->zoneAllocator.setColouring(enabled);
+}
+
+void Heap::setZoneGrowth(std::size_t maxPagesCount)
+{
+    LockGuard guard(m_lock);
+    impl()->zoneAllocator.setGrowth(maxPagesCount);
+}
+
+void* Heap::allocate(std::size_t size)
+{
+    void* ptr{};
+    {
+        LockGuard guard(m_lock);
+        ptr = impl()->zoneAllocator.allocate(size);
+    }
+
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+void* Heap::allocate(std::size_t size, Tier tier)
+{
+    void* ptr{};
+    {
+        LockGuard guard(m_lock);
+        ptr = impl()->zoneAllocator.allocate(size, tier);
+    }
+
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+void* Heap::allocate(std::size_t size, Caps caps, std::size_t boundary)
+{
+    void* ptr{};
+    {
+        LockGuard guard(m_lock);
+        ptr = impl()->zoneAllocator.allocate(size, caps, boundary);
+    }
+
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+void* Heap::allocateFromSizeClass(std::size_t sizeClassIdx, std::size_t size)
+{
+    void* ptr{};
+    {
+        LockGuard guard(m_lock);
+        ptr = impl()->zoneAllocator.allocateFromSizeClass(sizeClassIdx, size);
+    }
+
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+bool Heap::reserve(std::size_t size, std::size_t count)
+{
+    LockGuard guard(m_lock);
+    return impl()->zoneAllocator.reserve(size, count);
+}
+
+void* Heap::allocateReserved(std::size_t size)
+{
+    void* ptr{};
+    {
+        LockGuard guard(m_lock);
+        ptr = impl()->zoneAllocator.allocateReserved(size);
+    }
+
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+void Heap::release(void* ptr)
+{
+    if (m_tracer != nullptr && ptr != nullptr)
+        m_tracer->record(TraceEventType::eRelease, ptr, 0);
+
+    LockGuard guard(m_lock);
+    impl()->zoneAllocator.release(ptr);
+}
+
+void Heap::releaseDeferred(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    // Every block is at least as big as the pointer, so the link fits in the released memory.
+    auto* block = new (ptr) Impl::DeferredBlock{};
+    auto& head = impl()->deferredBlocks;
+    block->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {
+        // Failed exchange loads the current head into the link, so the push is simply retried.
+    }
+}
+
+std::size_t Heap::drain(std::size_t budget)
+{
+    LockGuard guard(m_lock);
+
+    // Whole stack is taken at once, so the pushes never race with removing single blocks.
+    std::size_t count = 0;
+    auto*& blocks = impl()->drainedBlocks;
+    while (count < budget) {
+        if (blocks == nullptr)
+            blocks = impl()->deferredBlocks.exchange(nullptr, std::memory_order_acquire);
+
+        if (blocks == nullptr)
+            break;
+
+        auto* block = blocks;
+        blocks = block->next;
+        if (m_tracer != nullptr)
+            m_tracer->record(TraceEventType::eRelease, block, 0);
+
+        impl()->zoneAllocator.release(block);
+        ++count;
+    }
+
+    return count;
+}
+
+void* Heap::tryReserve(std::size_t size)
+{
+    LockGuard guard(m_lock);
+
+    auto& pageAllocator = impl()->pageAllocator;
+    auto pageSize = pageAllocator.getStats().pageSize;
+    if (size == 0 || pageSize == 0)
+        return nullptr;
+
+    auto* pages = pageAllocator.allocate((size + pageSize - 1) / pageSize);
+    if (pages == nullptr)
+        return nullptr;
+
+    auto* ptr = reinterpret_cast<void*>(pages->address());
+    if (m_tracer != nullptr)
+        m_tracer->record(TraceEventType::eAllocate, ptr, size);
+
+    return ptr;
+}
+
+std::size_t Heap::largestFreeBlock()
+{
+    LockGuard guard(m_lock);
+
+    auto& pageAllocator = impl()->pageAllocator;
+    return pageAllocator.largestFreeGroupSize() * pageAllocator.getStats().pageSize;
+}
+
+double Heap::fragmentationIndex()
+{
+    LockGuard guard(m_lock);
+
+    auto& pageAllocator = impl()->pageAllocator;
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+    if (freePagesCount == 0)
+        return 0.0;
+
+    return 1.0 - double(pageAllocator.largestFreeGroupSize()) / double(freePagesCount);
+}
+
+std::size_t Heap::pageSize()
+{
+    LockGuard guard(m_lock);
+    return impl()->pageAllocator.getStats().pageSize;
+}
+
+allocator::Stats Heap::getStats()
+{
+    LockGuard guard(m_lock);
+
+    PageAllocator::Stats pageStats = impl()->pageAllocator.getStats();
+    ZoneAllocator::Stats zoneStats = impl()->zoneAllocator.getStats();
+
+    allocator::Stats stats{};
+    stats.totalMemorySize = pageStats.totalMemorySize;
+    // clang-format off
+    stats.reservedMemorySize = pageStats.totalMemorySize - pageStats.effectiveMemorySize // Lost due to the alignment.
+                               + pageStats.reservedPagesCount * pageStats.pageSize       // Reserved by the PageAllocator.
+                               + zoneStats.reservedMemorySize;                           // Reserved by the ZoneAllocator.
+    stats.userMemorySize = stats.totalMemorySize - stats.reservedMemorySize;
+    stats.allocatedMemorySize = pageStats.userMemorySize - pageStats.freeMemorySize - zoneStats.usedMemorySize // Allocated from PageAllocator by user.
+                                + zoneStats.allocatedMemorySize;                                               // Allocated from ZoneAllocator by user.
+    stats.freeMemorySize = stats.userMemorySize - stats.allocatedMemorySize;
+    // clang-format on
+
+    return stats;
+}
+
+allocator::ExtendedStats Heap::getExtendedStats()
+{
+    LockGuard guard(m_lock);
+
+    allocator::ExtendedStats stats{};
+    stats.sizeClassesCount = impl()->zoneAllocator.getSizeClassStats(stats.sizeClasses);
+    stats.regionsCount = impl()->pageAllocator.getRegionStats(stats.regions);
+    impl()->pageAllocator.getTierStats(stats.tiers);
+    return stats;
+}
+
+Heap::Impl* Heap::impl()
+{
+    return std::launder(reinterpret_cast<Impl*>(m_storage.data()));
+}
+
+} // namespace memory
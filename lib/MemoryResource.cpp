@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace memory {
+namespace {
+
+/// Reports the failed allocation in the way demanded from the memory resources.
+/// @param bytes        Demanded size of the memory block.
+/// @param alignment    Demanded alignment of the memory block.
+/// @return Never returns normally.
+/// @note Memory resources can't return nullptr, so the failure is delegated to the standard resource, which
+///       throws std::bad_alloc or terminates the program, depending on the exceptions support.
+void* allocationFailed(std::size_t bytes, std::size_t alignment)
+{
+    return std::pmr::null_memory_resource()->allocate(bytes, alignment);
+}
+
+} // namespace
+
+HeapResource::HeapResource(Heap* heap) noexcept
+    : m_heap(heap)
+{
+}
+
+Heap* HeapResource::heap() const
+{
+    return m_heap;
+}
+
+void* HeapResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Chunks are aligned to their power of 2 size and pages to the page size, so the alignment is satisfied by
+    // allocating at least that many bytes. Only alignments bigger than the page size have to be rejected.
+    auto* ptr = m_heap->allocate(std::max(bytes, alignment));
+    if (ptr == nullptr)
+        return allocationFailed(bytes, alignment);
+
+    if ((std::uintptr_t(ptr) & (alignment - 1)) != 0) {
+        m_heap->release(ptr);
+        return allocationFailed(bytes, alignment);
+    }
+
+    return ptr;
+}
+
+void HeapResource::do_deallocate(void* ptr, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] std::size_t alignment)
+{
+    m_heap->release(ptr);
+}
+
+bool HeapResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return (this == &other);
+}
+
+ArenaResource::ArenaResource(Arena* arena) noexcept
+    : m_arena(arena)
+{
+}
+
+Arena* ArenaResource::arena() const
+{
+    return m_arena;
+}
+
+void* ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Empty allocations still have to return unique pointers.
+    if (auto* ptr = m_arena->allocate(std::max(bytes, std::size_t(1)), alignment))
+        return ptr;
+
+    return allocationFailed(bytes, alignment);
+}
+
+void ArenaResource::do_deallocate([[maybe_unused]] void* ptr,
+                                  [[maybe_unused]] std::size_t bytes,
+                                  [[maybe_unused]] std::size_t alignment)
+{
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return (this == &other);
+}
+
+} // namespace memory
@@ -0,0 +1,266 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "ListNode.hpp"
+#include "utils.hpp"
+
+#include <allocator/Heap.hpp>
+#include <allocator/ObjectCache.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <tuple>
+
+namespace memory {
+
+/// Represents the header of the slab, that is stored at its beginning. Slabs are aligned to their size, so the
+/// slab of each object is found by masking the object address.
+struct Cache::Slab : public ListNode<Slab> {
+    std::size_t freeItemsCount; ///< Number of free items in the slab.
+
+    /// Returns the stack of indices of the free items, that is stored right after the slab header.
+    /// @return Pointer to the bottom of the stack. Index of the next free item is stored at freeItemsCount - 1.
+    std::uint16_t* freeItems() { return reinterpret_cast<std::uint16_t*>(this + 1); }
+};
+
+namespace {
+
+/// Minimal number of items in each slab.
+constexpr std::size_t cMinItemsPerSlab = 8;
+
+/// Maximal number of items in each slab, limited by the size of the free item indices.
+constexpr std::size_t cMaxItemsPerSlab = std::numeric_limits<std::uint16_t>::max();
+
+} // namespace
+
+Cache::~Cache()
+{
+    // Slabs with live objects are left in the heap, so that objects still in use are never finalized or reused.
+    std::ignore = clear();
+}
+
+bool Cache::init(Heap* heap,
+                 const char* name,
+                 std::size_t size,
+                 std::size_t alignment,
+                 ObjectFunction init,
+                 ObjectFunction fini)
+{
+    if (!clear() || heap == nullptr || size == 0 || !utils::isPowerOf2(alignment))
+        return false;
+
+    // Slab can't be bigger than the whole user memory of the heap, which also keeps the sizes from overflowing.
+    auto pageSize = heap->pageSize();
+    auto maxSlabSize = heap->getStats().userMemorySize;
+    if (pageSize == 0 || alignment > pageSize || pageSize > maxSlabSize || size > maxSlabSize)
+        return false;
+
+    // Objects keep their contents while they are free, so free items are tracked by their indices in the slab.
+    auto itemSize = utils::alignUp(size, alignment);
+    auto slabSize = pageSize;
+    std::size_t itemsPerSlab = 0;
+    std::size_t firstItemOffset = 0;
+    for (;; slabSize *= 2) {
+        itemsPerSlab = std::min((slabSize - sizeof(Slab)) / (itemSize + sizeof(std::uint16_t)), cMaxItemsPerSlab);
+        for (; itemsPerSlab != 0; --itemsPerSlab) {
+            firstItemOffset = utils::alignUp(sizeof(Slab) + itemsPerSlab * sizeof(std::uint16_t), alignment);
+            if (firstItemOffset + itemsPerSlab * itemSize <= slabSize)
+                break;
+        }
+
+        if (itemsPerSlab >= cMinItemsPerSlab)
+            break;
+
+        if (slabSize > maxSlabSize / 2)
+            return false;
+    }
+
+    m_heap = heap;
+    m_itemSize = itemSize;
+    m_firstItemOffset = firstItemOffset;
+    m_itemsPerSlab = itemsPerSlab;
+    m_init = init;
+    m_fini = fini;
+    m_stats.name = name;
+    m_stats.objectSize = size;
+    m_stats.slabSize = slabSize;
+    return true;
+}
+
+bool Cache::clear()
+{
+    if (m_partialSlabs != nullptr || m_fullSlabs != nullptr)
+        return false;
+
+    while (m_emptySlabs != nullptr)
+        destroySlab(m_emptySlabs);
+
+    m_heap = nullptr;
+    m_itemSize = 0;
+    m_firstItemOffset = 0;
+    m_itemsPerSlab = 0;
+    m_init = nullptr;
+    m_fini = nullptr;
+    m_stats = {};
+    return true;
+}
+
+void* Cache::allocate()
+{
+    if (m_heap == nullptr)
+        return nullptr;
+
+    auto* slab = (m_partialSlabs != nullptr) ? m_partialSlabs : m_emptySlabs;
+    if (slab == nullptr && (slab = createSlab()) == nullptr)
+        return nullptr;
+
+    auto** list = slabList(slab);
+    auto idx = slab->freeItems()[--slab->freeItemsCount]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    if (auto** newList = slabList(slab); newList != list) {
+        slab->removeFromList(list);
+        slab->addToList(newList);
+    }
+
+    ++m_stats.allocationsCount;
+    ++m_stats.liveObjectsCount;
+    m_stats.peakObjectsCount = std::max(m_stats.peakObjectsCount, m_stats.liveObjectsCount);
+    return object(slab, idx);
+}
+
+void Cache::release(void* object)
+{
+    if (object == nullptr)
+        return;
+
+    auto objectAddr = reinterpret_cast<std::uintptr_t>(object);
+    auto* slab = reinterpret_cast<Slab*>(objectAddr & ~(m_stats.slabSize - 1));
+    auto idx = (objectAddr - reinterpret_cast<std::uintptr_t>(slab) - m_firstItemOffset) / m_itemSize;
+    assert(idx < m_itemsPerSlab);
+    assert(slab->freeItemsCount < m_itemsPerSlab);
+
+    auto** list = slabList(slab);
+    auto* freeItems = slab->freeItems();
+    freeItems[slab->freeItemsCount++] = std::uint16_t(idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    ++m_stats.releasesCount;
+    --m_stats.liveObjectsCount;
+
+    auto** newList = slabList(slab);
+    if (newList == list)
+        return;
+
+    slab->removeFromList(list);
+    slab->addToList(newList);
+
+    // Only one empty slab is kept, so that its objects don't have to be initialized again on the next allocation.
+    if (newList == &m_emptySlabs && slab->next() != nullptr)
+        destroySlab(slab);
+}
+
+void Cache::trim()
+{
+    while (m_emptySlabs != nullptr)
+        destroySlab(m_emptySlabs);
+}
+
+allocator::CacheStats Cache::getStats() const
+{
+    return m_stats;
+}
+
+Cache::Slab* Cache::createSlab()
+{
+    // Slab, that doesn't cross the boundary equal to its power of 2 size, is aligned to that size.
+    auto* memory = m_heap->allocate(m_stats.slabSize, Caps::eNone, m_stats.slabSize);
+    if (memory == nullptr)
+        return nullptr;
+
+    auto* slab = new (memory) Slab();
+    slab->freeItemsCount = m_itemsPerSlab;
+
+    // Indices are stacked in the reversed order, so that items are allocated in the order of their addresses.
+    auto* freeItems = slab->freeItems();
+    for (std::size_t i = 0; i < m_itemsPerSlab; ++i) {
+        freeItems[i] = std::uint16_t(m_itemsPerSlab - 1 - i); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        if (m_init != nullptr)
+            m_init(object(slab, i));
+    }
+
+    slab->addToList(&m_emptySlabs);
+    ++m_stats.slabsCount;
+    m_stats.objectsCount += m_itemsPerSlab;
+    m_stats.initsCount += m_itemsPerSlab;
+    return slab;
+}
+
+void Cache::destroySlab(Slab* slab)
+{
+    assert(slab);
+
+    slab->removeFromList(slabList(slab));
+
+    if (m_fini != nullptr) {
+        for (std::size_t i = 0; i < m_itemsPerSlab; ++i)
+            m_fini(object(slab, i));
+    }
+
+    --m_stats.slabsCount;
+    m_stats.objectsCount -= m_itemsPerSlab;
+    m_heap->release(slab);
+}
+
+void* Cache::object(Slab* slab, std::size_t idx) const
+{
+    assert(slab);
+
+    return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(slab) + m_firstItemOffset + idx * m_itemSize);
+}
+
+Cache::Slab** Cache::slabList(Slab* slab)
+{
+    assert(slab);
+
+    if (slab->freeItemsCount == 0)
+        return &m_fullSlabs;
+
+    if (slab->freeItemsCount == m_itemsPerSlab)
+        return &m_emptySlabs;
+
+    return &m_partialSlabs;
+}
+
+} // namespace memory
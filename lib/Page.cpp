@@ -63,6 +63,18 @@ void Page::setUsed(bool value)
     m_flags.bits.used = value;
 }
 
+void Page::setZoneHeader(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.zoneHeader = value;
+}
+
+void Page::setPinned(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.pinned = value;
+}
+
 Page* Page::nextSibling()
 {
     return (this + 1);
@@ -90,4 +102,16 @@ bool Page::isUsed() const
     return m_flags.bits.used;
 }
 
+bool Page::hasZoneHeader() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.zoneHeader;
+}
+
+bool Page::isPinned() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.pinned;
+}
+
 } // namespace memory
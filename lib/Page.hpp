@@ -83,6 +83,14 @@ public:
     /// @param value        State to be set.
     void setUsed(bool value);
 
+    /// Sets the 'zoneHeader' flag of the current page to the given state.
+    /// @param value        State to be set.
+    void setZoneHeader(bool value);
+
+    /// Sets the 'pinned' flag of the current page to the given state.
+    /// @param value        State to be set.
+    void setPinned(bool value);
+
     /// Returns the page, that lies immediately after the given page.
     /// @return Pointer to the next sibling page.
     Page* nextSibling();
@@ -105,6 +113,18 @@ public:
     /// @retval false       Page is not used.
     [[nodiscard]] bool isUsed() const;
 
+    /// Returns flag indicating if current page starts with the header of the zone, that it belongs to.
+    /// @return Flag indicating if current page starts with the zone header.
+    /// @retval true        Page starts with the zone header.
+    /// @retval false       Page doesn't contain the zone header.
+    [[nodiscard]] bool hasZoneHeader() const;
+
+    /// Returns flag indicating if current page belongs to the zone pinned for reserved allocations.
+    /// @return Flag indicating if current page is pinned.
+    /// @retval true        Page is pinned.
+    /// @retval false       Page is not pinned.
+    [[nodiscard]] bool isPinned() const;
+
     /// Checks if the Page class is naturally aligned.
     /// @return Flag indicating it the Page class is naturally aligned.
     /// @retval true        Page class is naturally aligned.
@@ -124,6 +144,8 @@ private:
         struct PageFlags {
             std::size_t groupSize : 21; ///< Size of the group. This is set only for the first and last page in group.
             bool used : 1;              ///< Flag indicating whether this page is used or not.
+            bool zoneHeader : 1;        ///< Flag indicating whether this page starts with the zone header.
+            bool pinned : 1;            ///< Flag indicating whether this page belongs to the pinned zone.
         };
 
         PageFlags bits;
@@ -37,6 +37,7 @@
 
 #include <allocator/Region.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <numeric>
 
@@ -97,6 +98,8 @@ bool PageAllocator::init(Region* regions, std::size_t pageSize)
 
         if (group != nullptr)
             addGroup(group);
+
+        region.peakUsedPagesCount = region.pageCount - region.freePagesCount;
     }
 
     return true;
@@ -113,43 +116,91 @@ void PageAllocator::clear()
     m_descPagesCount = 0;
     m_pagesHead = nullptr;
     m_pagesTail = nullptr;
-    m_freeGroupLists.fill(nullptr);
+    m_tiers.fill({});
     m_pagesCount = 0;
     m_freePagesCount = 0;
 }
 
-Page* PageAllocator::allocate(std::size_t count)
+Page* PageAllocator::allocate(std::size_t count, Tier tier, Caps caps, std::size_t boundary)
 {
     if (m_freePagesCount < count || count == 0)
         return nullptr;
 
-    std::size_t idx = groupIdx(count);
-    for (auto i = idx; i < m_freeGroupLists.size(); ++i) {
-        for (Page* group = m_freeGroupLists.at(i); group != nullptr; group = group->next()) {
-            if (group->groupSize() < count)
-                continue;
+    if (boundary != 0 && (!utils::isPowerOf2(boundary) || count * m_pageSize > boundary))
+        return nullptr;
 
-            removeGroup(group);
+    auto requestedIdx = std::size_t(tier);
+    ++m_tiers.at(requestedIdx).requestsCount;
 
-            Page* allocatedGroup = nullptr;
-            Page* remainingGroup = nullptr;
-            std::tie(allocatedGroup, remainingGroup) = splitGroup(group, count);
+    if (auto* pages = allocateWithFallback(count, requestedIdx, caps, boundary))
+        return pages;
 
-            if (remainingGroup != nullptr)
-                addGroup(remainingGroup);
+    // Groups kept in the quick lists can join into a group big enough, so the search is repeated after flushing.
+    if (flushQuickLists() == 0)
+        return nullptr;
 
-            return allocatedGroup;
-        }
+    return allocateWithFallback(count, requestedIdx, caps, boundary);
+}
+
+Page* PageAllocator::allocateWithFallback(std::size_t count, std::size_t requestedIdx, Caps caps, std::size_t boundary)
+{
+    // Requested tier is tried first, then the slower ones and finally the faster ones, nearest first.
+    for (std::size_t i = 0; i < cTiersCount; ++i) {
+        auto tierIdx = (requestedIdx + i < cTiersCount) ? requestedIdx + i : cTiersCount - 1 - i;
+        auto* pages = allocateFromTier(count, tierIdx, caps, boundary);
+        if (pages == nullptr)
+            continue;
+
+        if (tierIdx != requestedIdx)
+            ++m_tiers.at(requestedIdx).fallbacksCount;
+
+        m_tiers.at(tierIdx).servedPagesCount += count;
+        return pages;
     }
 
     return nullptr;
 }
 
+Page* PageAllocator::allocateSeparate(std::size_t count, Tier tier, Caps caps)
+{
+    auto* pages = allocate(count, tier, caps);
+    if (pages == nullptr)
+        return nullptr;
+
+    // Each split is O(1), because it touches only the group boundaries, so the whole group is split in O(count).
+    for (auto* group = pages; group->groupSize() > 1;)
+        std::tie(std::ignore, group) = splitGroup(group, 1);
+
+    return pages;
+}
+
 void PageAllocator::release(Page* pages)
 {
     if (pages == nullptr)
         return;
 
+    auto count = pages->groupSize();
+    if (count > m_cQuickListsCount) {
+        coalesce(pages);
+        return;
+    }
+
+    // Pages in the quick lists stay marked as used, so that the released neighbours don't join with them.
+    auto* region = getRegion(pages->address());
+    auto tierIdx = std::size_t(region->tier);
+    auto& tierInfo = m_tiers.at(tierIdx);
+    pages->addToList(&tierInfo.quickLists.at(count - 1));
+    m_freePagesCount += count;
+    region->freePagesCount += count;
+
+    if (++tierInfo.quickListLengths.at(count - 1) >= m_cMaxQuickListLength)
+        flushQuickList(tierIdx, count - 1);
+}
+
+void PageAllocator::coalesce(Page* pages)
+{
+    assert(pages);
+
     // clang-format off
     Page* joinedGroup = pages;
 
@@ -201,15 +252,29 @@ Page* PageAllocator::getPage(std::uintptr_t addr)
     if (pageRegion == nullptr)
         return nullptr;
 
-    Page* result = nullptr;
-    for (auto* page = pageRegion->firstPage; page <= pageRegion->lastPage; page = page->nextSibling()) {
-        if (page->address() == alignedAddr) {
-            result = page;
-            break;
-        }
-    }
+    // Page descriptors of each region are stored in the same order as the pages they describe.
+    auto idx = (alignedAddr - pageRegion->alignedStart) / m_pageSize;
+    return pageRegion->firstPage + idx;
+}
 
-    return result;
+Caps PageAllocator::getCaps(Page* page)
+{
+    assert(page);
+
+    auto* region = getRegion(page->address());
+    assert(region);
+
+    return region->caps;
+}
+
+Tier PageAllocator::getTier(Page* page)
+{
+    assert(page);
+
+    auto* region = getRegion(page->address());
+    assert(region);
+
+    return region->tier;
 }
 
 PageAllocator::Stats PageAllocator::getStats()
@@ -234,6 +299,94 @@ PageAllocator::Stats PageAllocator::getStats()
     return stats;
 }
 
+std::size_t PageAllocator::getRegionStats(std::array<allocator::RegionStats, allocator::cMaxRegionsCount>& regionStats)
+{
+    regionStats.fill({});
+
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        const auto& region = m_regionsInfo.at(i);
+        auto& stats = regionStats.at(i);
+        stats.start = region.alignedStart;
+        stats.tier = region.tier;
+        stats.caps = region.caps;
+        stats.pagesCount = region.pageCount;
+        stats.freePagesCount = region.freePagesCount;
+        stats.peakUsedPagesCount = region.peakUsedPagesCount;
+    }
+
+    // Groups in the quick lists are reported as they are, so that reading statistics doesn't change the allocator.
+    for (const auto& tierInfo : m_tiers) {
+        for (auto* group : tierInfo.freeGroupLists) {
+            for (; group != nullptr; group = group->next()) {
+                auto idx = std::size_t(getRegion(group->address()) - m_regionsInfo.data());
+                auto& stats = regionStats.at(idx);
+                stats.largestFreeGroupSize = std::max(stats.largestFreeGroupSize, group->groupSize());
+            }
+        }
+
+        for (auto* group : tierInfo.quickLists) {
+            for (; group != nullptr; group = group->next()) {
+                auto idx = std::size_t(getRegion(group->address()) - m_regionsInfo.data());
+                auto& stats = regionStats.at(idx);
+                stats.largestFreeGroupSize = std::max(stats.largestFreeGroupSize, group->groupSize());
+            }
+        }
+    }
+
+    return m_validRegionsCount;
+}
+
+void PageAllocator::getTierStats(std::array<allocator::TierStats, cTiersCount>& tierStats)
+{
+    tierStats.fill({});
+
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        const auto& region = m_regionsInfo.at(i);
+        auto& stats = tierStats.at(std::size_t(region.tier));
+        stats.pagesCount += region.pageCount;
+        stats.freePagesCount += region.freePagesCount;
+    }
+
+    for (std::size_t i = 0; i < cTiersCount; ++i) {
+        const auto& tierInfo = m_tiers.at(i);
+        auto& stats = tierStats.at(i);
+        stats.requestsCount = tierInfo.requestsCount;
+        stats.fallbacksCount = tierInfo.fallbacksCount;
+        stats.servedPagesCount = tierInfo.servedPagesCount;
+    }
+}
+
+std::size_t PageAllocator::largestFreeGroupSize()
+{
+    std::size_t largestSize = 0;
+    for (auto& tierInfo : m_tiers) {
+        if (!tierInfo.largestGroupValid) {
+            tierInfo.largestGroupSize = 0;
+            for (auto it = tierInfo.freeGroupLists.rbegin(); it != tierInfo.freeGroupLists.rend(); ++it) {
+                for (Page* group = *it; group != nullptr; group = group->next())
+                    tierInfo.largestGroupSize = std::max(tierInfo.largestGroupSize, group->groupSize());
+
+                if (tierInfo.largestGroupSize != 0)
+                    break;
+            }
+
+            tierInfo.largestGroupValid = true;
+        }
+
+        largestSize = std::max(largestSize, tierInfo.largestGroupSize);
+
+        // All groups in one quick list have the same size, so only the highest non-empty list matters.
+        for (std::size_t i = m_cQuickListsCount; i > 0; --i) {
+            if (tierInfo.quickLists.at(i - 1) != nullptr) {
+                largestSize = std::max(largestSize, i);
+                break;
+            }
+        }
+    }
+
+    return largestSize;
+}
+
 std::size_t PageAllocator::countPages()
 {
     std::size_t pagesCount = 0;
@@ -247,13 +400,24 @@ std::size_t PageAllocator::chooseDescRegion()
 {
     std::size_t descAreaSize = m_pagesCount * sizeof(Page);
 
+    // Page descriptors don't need any special memory, so they are kept away from regions with capabilities or in
+    // the fast tier, unless none of the other regions can hold them.
+    auto isPlain = [](const RegionInfo& region) { return region.caps == Caps::eNone && region.tier != Tier::eFast; };
+
     std::size_t selectedIdx = 0;
+    bool selectedFits = false;
     for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
-        if (m_regionsInfo.at(i).alignedSize < descAreaSize)
+        const auto& region = m_regionsInfo.at(i);
+        if (region.alignedSize < descAreaSize)
             continue;
 
-        if (m_regionsInfo.at(i).alignedSize < m_regionsInfo.at(selectedIdx).alignedSize)
+        const auto& selected = m_regionsInfo.at(selectedIdx);
+        bool isBetter = (isPlain(region) == isPlain(selected)) ? region.alignedSize < selected.alignedSize
+                                                               : isPlain(region);
+        if (!selectedFits || isBetter) {
             selectedIdx = i;
+            selectedFits = true;
+        }
     }
 
     return selectedIdx;
@@ -277,6 +441,122 @@ std::size_t PageAllocator::reserveDescPages()
     return reservedCount;
 }
 
+Page* PageAllocator::allocateFromTier(std::size_t count, std::size_t tierIdx, Caps caps, std::size_t boundary)
+{
+    if (count <= m_cQuickListsCount) {
+        if (auto* group = allocateFromQuickList(count, tierIdx, caps, boundary))
+            return group;
+    }
+
+    auto& freeGroupLists = m_tiers.at(tierIdx).freeGroupLists;
+
+    std::size_t idx = groupIdx(count);
+    for (auto i = idx; i < freeGroupLists.size(); ++i) {
+        for (Page* group = freeGroupLists.at(i); group != nullptr; group = group->next()) {
+            if (group->groupSize() < count)
+                continue;
+
+            auto* region = getRegion(group->address());
+            if (!hasCaps(region->caps, caps))
+                continue;
+
+            auto offset = boundaryOffset(group, count, boundary);
+            if (offset + count > group->groupSize())
+                continue;
+
+            removeGroup(group);
+
+            Page* allocatedGroup = group;
+            Page* remainingGroup = nullptr;
+            if (offset != 0) {
+                std::tie(remainingGroup, allocatedGroup) = splitGroup(group, offset);
+                addGroup(remainingGroup);
+            }
+
+            std::tie(allocatedGroup, remainingGroup) = splitGroup(allocatedGroup, count);
+            if (remainingGroup != nullptr)
+                addGroup(remainingGroup);
+
+            // Peak is updated only here, because free pages are also taken temporarily while joining groups.
+            auto usedPagesCount = region->pageCount - region->freePagesCount;
+            region->peakUsedPagesCount = std::max(region->peakUsedPagesCount, usedPagesCount);
+            return allocatedGroup;
+        }
+    }
+
+    return nullptr;
+}
+
+Page* PageAllocator::allocateFromQuickList(std::size_t count, std::size_t tierIdx, Caps caps, std::size_t boundary)
+{
+    auto& tierInfo = m_tiers.at(tierIdx);
+    auto& quickList = tierInfo.quickLists.at(count - 1);
+    for (Page* group = quickList; group != nullptr; group = group->next()) {
+        auto* region = getRegion(group->address());
+        if (!hasCaps(region->caps, caps) || boundaryOffset(group, count, boundary) != 0)
+            continue;
+
+        // Groups in the quick lists are still marked as used and have the exact size, so they are taken as they are.
+        group->removeFromList(&quickList);
+        --tierInfo.quickListLengths.at(count - 1);
+        m_freePagesCount -= count;
+        region->freePagesCount -= count;
+
+        auto usedPagesCount = region->pageCount - region->freePagesCount;
+        region->peakUsedPagesCount = std::max(region->peakUsedPagesCount, usedPagesCount);
+        return group;
+    }
+
+    return nullptr;
+}
+
+std::size_t PageAllocator::flushQuickList(std::size_t tierIdx, std::size_t listIdx)
+{
+    auto& tierInfo = m_tiers.at(tierIdx);
+    auto& quickList = tierInfo.quickLists.at(listIdx);
+
+    std::size_t flushedCount = 0;
+    while (auto* group = quickList) {
+        auto count = group->groupSize();
+        auto* region = getRegion(group->address());
+        group->removeFromList(&quickList);
+        m_freePagesCount -= count;
+        region->freePagesCount -= count;
+
+        // Group is counted as free again, when it is added to the free groups after joining.
+        coalesce(group);
+        flushedCount += count;
+    }
+
+    tierInfo.quickListLengths.at(listIdx) = 0;
+    return flushedCount;
+}
+
+std::size_t PageAllocator::flushQuickLists()
+{
+    std::size_t flushedCount = 0;
+    for (std::size_t tierIdx = 0; tierIdx < m_tiers.size(); ++tierIdx) {
+        for (std::size_t listIdx = 0; listIdx < m_cQuickListsCount; ++listIdx)
+            flushedCount += flushQuickList(tierIdx, listIdx);
+    }
+
+    return flushedCount;
+}
+
+std::size_t PageAllocator::boundaryOffset(Page* group, std::size_t count, std::size_t boundary)
+{
+    if (boundary == 0)
+        return 0;
+
+    auto start = group->address();
+    auto end = start + count * m_pageSize - 1;
+    if ((start & ~(boundary - 1)) == (end & ~(boundary - 1)))
+        return 0;
+
+    // Boundaries are powers of 2 not smaller than the page, so the next one is page aligned and fits the pages.
+    return (utils::alignUp(start, boundary) - start) / m_pageSize;
+}
+
 bool PageAllocator::isValidPage(Page* page)
 {
     return (page >= m_pagesHead && page <= m_pagesTail);
@@ -289,7 +569,7 @@ RegionInfo* PageAllocator::getRegion(std::uintptr_t addr)
     for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
         auto& region = m_regionsInfo.at(i);
 
-        if (region.alignedStart <= alignedAddr && region.alignedEnd >= alignedAddr)
+        if (region.alignedStart <= alignedAddr && region.alignedEnd > alignedAddr)
             return &region;
     }
 
@@ -300,9 +580,19 @@ void PageAllocator::addGroup(Page* group)
 {
     assert(group);
 
+    auto* region = getRegion(group->address());
+    auto& tierInfo = m_tiers.at(std::size_t(region->tier));
     std::size_t idx = groupIdx(group->groupSize());
-    group->addToList(&m_freeGroupLists.at(idx));
+    group->addToList(&tierInfo.freeGroupLists.at(idx));
+
+    // Group not smaller than the removed largest one is the largest again, e.g. after joining with it.
+    if (group->groupSize() >= tierInfo.largestGroupSize) {
+        tierInfo.largestGroupSize = group->groupSize();
+        tierInfo.largestGroupValid = true;
+    }
+
     m_freePagesCount += group->groupSize();
+    region->freePagesCount += group->groupSize();
 
     for (std::size_t i = 0; i < group->groupSize(); ++i) {
         auto* page = group + i;
@@ -314,9 +604,17 @@ void PageAllocator::removeGroup(Page* group)
 {
     assert(group);
 
+    auto* region = getRegion(group->address());
+    auto& tierInfo = m_tiers.at(std::size_t(region->tier));
     std::size_t idx = groupIdx(group->groupSize());
-    group->removeFromList(&m_freeGroupLists.at(idx));
+    group->removeFromList(&tierInfo.freeGroupLists.at(idx));
+
+    // Another group of the same size can still be free, so the maximum is found again only when it is demanded.
+    if (group->groupSize() == tierInfo.largestGroupSize)
+        tierInfo.largestGroupValid = false;
+
     m_freePagesCount -= group->groupSize();
+    region->freePagesCount -= group->groupSize();
 
     for (std::size_t i = 0; i < group->groupSize(); ++i) {
         auto* page = group + i;
@@ -35,6 +35,9 @@
 #include "RegionInfo.hpp"
 #include "utils.hpp"
 
+#include <allocator/Region.hpp>
+#include <allocator/Stats.hpp>
+
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -43,7 +46,6 @@
 namespace memory {
 
 class Page;
-struct Region;
 
 /// Represents an allocator of physical pages.
 class PageAllocator {
@@ -76,14 +78,37 @@ public:
 
     /// Allocates the given number of physical pages.
     /// @param count            Number of pages to be allocated.
+    /// @param tier             Tier of the memory, from which pages should be allocated.
+    /// @param caps             Capabilities demanded from the region of the allocated pages.
+    /// @param boundary         Address boundary, that allocated pages must not cross or 0 if there is no such limit.
     /// @return Result of the allocation.
     /// @retval Page*           A set of allocated pages on success.
     /// @retval nullptr         Some error occurred.
     /// @note All allocated pages must be from the same region.
-    [[nodiscard]] Page* allocate(std::size_t count);
+    /// @note If the requested tier has no group big enough, then slower tiers are tried first and faster ones
+    ///       afterwards, each starting from the nearest one.
+    /// @note Boundary has to be a power of 2 and can't be smaller than the total size of the allocated pages.
+    [[nodiscard]] Page* allocate(std::size_t count,
+                                 Tier tier = Tier::eNormal,
+                                 Caps caps = Caps::eNone,
+                                 std::size_t boundary = 0);
+
+    /// Allocates the given number of consecutive physical pages, that can be released separately.
+    /// @param count            Number of pages to be allocated.
+    /// @param tier             Tier of the memory, from which pages should be allocated.
+    /// @param caps             Capabilities demanded from the region of the allocated pages.
+    /// @return Result of the allocation.
+    /// @retval Page*           First of the allocated pages on success. Remaining ones are its next siblings.
+    /// @retval nullptr         Some error occurred.
+    /// @note This allows to take many pages with a single search of the free groups, when each of them is used on
+    ///       its own, e.g. by a zone.
+    [[nodiscard]] Page* allocateSeparate(std::size_t count, Tier tier = Tier::eNormal, Caps caps = Caps::eNone);
 
     /// Releases the given set of pages.
     /// @param pages            List of pages to be released.
+    /// @note Small groups are kept in the quick lists of their tier without joining them with the neighbouring free
+    ///       groups, so that they can be allocated again without splitting. Quick lists are coalesced when one of
+    ///       them gets too long or when an allocation can't be served without them.
     void release(Page* pages);
 
     /// Returns the Page, which contains the given address.
@@ -93,10 +118,40 @@ public:
     /// @retval nullptr         There is no page with the given address.
     Page* getPage(std::uintptr_t addr);
 
+    /// Returns the capabilities of the region, which contains the given page.
+    /// @param page             Page to be checked.
+    /// @return Capabilities of the region of the given page.
+    Caps getCaps(Page* page);
+
+    /// Returns the tier of the region, which contains the given page.
+    /// @param page             Page to be checked.
+    /// @return Tier of the region of the given page.
+    Tier getTier(Page* page);
+
     /// Returns the current statistics of PageAllocator.
     /// @return PageAllocator statistics.
     Stats getStats();
 
+    /// Returns the current statistics of each memory region known to the PageAllocator.
+    /// @param regionStats      Array to be filled with the statistics of the regions.
+    /// @return Number of valid entries in the given array.
+    /// @note Finding the largest free group requires walking the free groups, so this is not meant for hot paths.
+    /// @note Groups in the quick lists are reported as separate free groups, because they are not joined yet.
+    std::size_t getRegionStats(std::array<allocator::RegionStats, allocator::cMaxRegionsCount>& regionStats);
+
+    /// Returns the current statistics of each memory tier.
+    /// @param tierStats        Array to be filled with the statistics of the tiers, indexed by Tier.
+    void getTierStats(std::array<allocator::TierStats, cTiersCount>& tierStats);
+
+    /// Returns the number of pages in the largest group of free pages.
+    /// @return Number of pages, that can be allocated at once.
+    /// @note Size of the largest group is kept as a running maximum of each tier, so this is O(1) as long as that
+    ///       group stays free. Otherwise only the highest non-empty bucket of free groups in the tier is scanned once,
+    ///       because all groups in lower buckets are smaller than any group in it.
+    /// @note Groups in the quick lists count as free groups without joining them, so allocations of bigger groups
+    ///       may still succeed after allocate() coalesces the quick lists.
+    std::size_t largestFreeGroupSize();
+
     /// Returns minimal supported size of the page.
     /// @return Minimal supported size of the page.
     static constexpr std::size_t minimalPageSize()
@@ -112,12 +167,66 @@ private:
 
     /// Returns the index of the best region to store the page descriptors.
     /// @return Index of the region, where page descriptors will be stored.
+    /// @note The smallest region big enough is selected, preferring regions without capabilities outside the fast tier.
     std::size_t chooseDescRegion();
 
     /// Reserves the necessary number of pages to store the page descriptors.
     /// @return Number of pages, that are used to store the page descriptors.
     std::size_t reserveDescPages();
 
+    /// Allocates the given number of physical pages from the regions of the given tier.
+    /// @param count            Number of pages to be allocated.
+    /// @param tierIdx          Index of the tier, from which pages should be allocated.
+    /// @param caps             Capabilities demanded from the region of the allocated pages.
+    /// @param boundary         Address boundary, that allocated pages must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         There is no fitting group in the given tier.
+    Page* allocateFromTier(std::size_t count, std::size_t tierIdx, Caps caps, std::size_t boundary);
+
+    /// Allocates the given number of physical pages from the requested tier or the other ones as a fallback.
+    /// @param count            Number of pages to be allocated.
+    /// @param requestedIdx     Index of the tier, from which pages should be allocated first.
+    /// @param caps             Capabilities demanded from the region of the allocated pages.
+    /// @param boundary         Address boundary, that allocated pages must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         There is no fitting group in any tier.
+    Page* allocateWithFallback(std::size_t count, std::size_t requestedIdx, Caps caps, std::size_t boundary);
+
+    /// Allocates the group with exactly the given number of physical pages from the quick list of the given tier.
+    /// @param count            Number of pages to be allocated.
+    /// @param tierIdx          Index of the tier, from which pages should be allocated.
+    /// @param caps             Capabilities demanded from the region of the allocated pages.
+    /// @param boundary         Address boundary, that allocated pages must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         There is no fitting group in the quick list.
+    Page* allocateFromQuickList(std::size_t count, std::size_t tierIdx, Caps caps, std::size_t boundary);
+
+    /// Releases all groups from the given quick list and joins them with the neighbouring free groups.
+    /// @param tierIdx          Index of the tier, which quick list should be flushed.
+    /// @param listIdx          Index of the quick list to be flushed.
+    /// @return Number of released pages.
+    std::size_t flushQuickList(std::size_t tierIdx, std::size_t listIdx);
+
+    /// Releases the groups from all quick lists and joins them with the neighbouring free groups.
+    /// @return Number of released pages.
+    std::size_t flushQuickLists();
+
+    /// Joins the given used group with the neighbouring free groups and adds the result to the free groups.
+    /// @param pages            Group to be released.
+    void coalesce(Page* pages);
+
+    /// Returns the number of pages, that have to be skipped at the beginning of the given group, so that the given
+    /// number of pages following them doesn't cross the boundary.
+    /// @param group            Group to be checked.
+    /// @param count            Number of pages to be allocated.
+    /// @param boundary         Address boundary, that allocated pages must not cross or 0 if there is no such limit.
+    /// @return Number of pages to be skipped.
+    /// @note Boundary can't be smaller than the total size of the allocated pages.
+    std::size_t boundaryOffset(Page* group, std::size_t count, std::size_t boundary);
+
     /// Checks if the given page is valid.
     /// @param page             Page to be checked.
     /// @return Flag indicating if the given page is valid.
@@ -141,10 +250,27 @@ private:
     void removeGroup(Page* group);
 
 private:
-    static constexpr int m_cMaxRegionsCount = 8; ///< Maximal supported number of memory regions.
-    static constexpr int m_cMaxGroupIdx = 20;    ///< Maximal index of the group in the free array.
+    /// Maximal supported number of memory regions.
+    static constexpr int m_cMaxRegionsCount = allocator::cMaxRegionsCount;
+    static constexpr int m_cMaxGroupIdx = 20;                ///< Maximal index of the group in the free array.
+    static constexpr std::size_t m_cQuickListsCount = 4;     ///< Number of quick lists, one for each group size.
+    static constexpr std::size_t m_cMaxQuickListLength = 16; ///< Number of groups, that triggers flushing the list.
 
 private:
+    /// Represents the meta-data of the memory tier.
+    struct TierInfo {
+        std::array<Page*, m_cMaxGroupIdx> freeGroupLists{}; ///< Array of the groups with free pages in this tier.
+        std::size_t requestsCount{};                        ///< Number of page allocations requested from this tier.
+        std::size_t fallbacksCount{};                       ///< Number of requests served from another tier.
+        std::size_t servedPagesCount{};                     ///< Number of pages allocated from this tier.
+        std::size_t largestGroupSize{};                     ///< Running maximum of the free group sizes in this tier.
+        bool largestGroupValid{true};                       ///< Flag indicating if the running maximum is exact.
+        /// Released groups with 1 to m_cQuickListsCount pages, that are not joined with their neighbours yet.
+        std::array<Page*, m_cQuickListsCount> quickLists{};
+        /// Number of groups in each quick list.
+        std::array<std::size_t, m_cQuickListsCount> quickListLengths{};
+    };
+
     std::array<RegionInfo, m_cMaxRegionsCount> m_regionsInfo{}; ///< Array describing all known regions.
     std::size_t m_validRegionsCount{};                          ///< Number of used regions.
     std::size_t m_pageSize{};                                   ///< Size of the page used on this platform.
@@ -152,7 +278,7 @@ private:
     std::size_t m_descPagesCount{};                             ///< Number of pages used to store page descriptors.
     Page* m_pagesHead{};                                        ///< Head of the page descriptors list.
     Page* m_pagesTail{};                                        ///< Tail of the page descriptors list.
-    std::array<Page*, m_cMaxGroupIdx> m_freeGroupLists{};       ///< Array of the groups with free pages.
+    std::array<TierInfo, cTiersCount> m_tiers{};                ///< Array describing all memory tiers.
     std::size_t m_pagesCount{};                                 ///< Total number of pages known to the PageAllocator.
     std::size_t m_freePagesCount{};                             ///< Current number of free pages.
 };
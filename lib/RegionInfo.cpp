@@ -50,8 +50,12 @@ void clearRegionInfo(RegionInfo& regionInfo)
     regionInfo.pageCount = 0;
     regionInfo.size = 0;
     regionInfo.alignedSize = 0;
+    regionInfo.tier = Tier::eNormal;
+    regionInfo.caps = Caps::eNone;
     regionInfo.firstPage = nullptr;
     regionInfo.lastPage = nullptr;
+    regionInfo.freePagesCount = 0;
+    regionInfo.peakUsedPagesCount = 0;
 }
 
 bool initRegionInfo(RegionInfo& regionInfo, const Region& region, std::size_t pageSize)
@@ -77,6 +81,8 @@ bool initRegionInfo(RegionInfo& regionInfo, const Region& region, std::size_t pa
 
     regionInfo.size = region.size;
     regionInfo.alignedSize = regionInfo.pageCount * pageSize;
+    regionInfo.tier = region.tier;
+    regionInfo.caps = region.caps;
 
     return true;
 }
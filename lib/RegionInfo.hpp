@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <allocator/Region.hpp>
+
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -39,19 +41,22 @@
 namespace memory {
 
 class Page;
-struct Region;
 
 /// Represents the meta data of the physical memory region.
 struct RegionInfo {
-    std::uintptr_t start;        ///< Physical address of the region start.
-    std::uintptr_t end;          ///< Physical address of the region end.
-    std::uintptr_t alignedStart; ///< Aligned physical address of the region start.
-    std::uintptr_t alignedEnd;   ///< Aligned physical address of the region end.
-    std::size_t pageCount;       ///< Number of pages, that this region contains.
-    std::size_t size;            ///< Size of the region.
-    std::size_t alignedSize;     ///< Size of the aligned part of the region.
-    Page* firstPage;             ///< Pointer to the first page in the region.
-    Page* lastPage;              ///< Pointer to the last page in the region.
+    std::uintptr_t start;           ///< Physical address of the region start.
+    std::uintptr_t end;             ///< Physical address of the region end.
+    std::uintptr_t alignedStart;    ///< Aligned physical address of the region start.
+    std::uintptr_t alignedEnd;      ///< Aligned physical address of the region end.
+    std::size_t pageCount;          ///< Number of pages, that this region contains.
+    std::size_t size;               ///< Size of the region.
+    std::size_t alignedSize;        ///< Size of the aligned part of the region.
+    Tier tier;                      ///< Speed tier of the region.
+    Caps caps;                      ///< Capabilities of the region.
+    Page* firstPage;                ///< Pointer to the first page in the region.
+    Page* lastPage;                 ///< Pointer to the last page in the region.
+    std::size_t freePagesCount;     ///< Current number of free pages in the region.
+    std::size_t peakUsedPagesCount; ///< Highest number of used pages in the region.
 };
 
 /// Clears the contents of the region info.
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "utils.hpp"
+
+#include <allocator/Tracer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace memory {
+namespace {
+
+/// Returns the sequence number of the slot holding the completely written event with the given index.
+/// @param idx          Index of the event.
+/// @return Sequence number of the slot.
+/// @note Sequence numbers of written events are even and sequence number 0 marks the slot, that was never written.
+constexpr std::size_t writtenSequence(std::size_t idx)
+{
+    return (idx + 1) * 2;
+}
+
+} // namespace
+
+bool Tracer::init(TraceSlot* slots, std::size_t capacity, ClockFunction clock, ThreadIdFunction threadId)
+{
+    clear();
+
+    if (slots == nullptr || !utils::isPowerOf2(capacity))
+        return false;
+
+    // Storage can be reused from another tracer, so old sequence numbers can't be mistaken for the new events.
+    for (std::size_t i = 0; i < capacity; ++i) {
+        auto& slot = slots[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    m_slots = slots;
+    m_capacity = capacity;
+    m_clock = clock;
+    m_threadId = threadId;
+    return true;
+}
+
+void Tracer::clear()
+{
+    m_slots = nullptr;
+    m_capacity = 0;
+    m_clock = nullptr;
+    m_threadId = nullptr;
+    m_recorded.store(0, std::memory_order_relaxed);
+}
+
+void Tracer::record(TraceEventType type, const void* ptr, std::size_t size)
+{
+    if (m_slots == nullptr)
+        return;
+
+    auto idx = m_recorded.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = m_slots[idx & (m_capacity - 1)]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    // Slot can be taken only from the completely written older event. After the wrap-around it can still be written
+    // by the older event or already by a newer one, so this event is dropped and the export counts it as such.
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+        auto age = writtenSequence(idx) - sequence;
+        if ((sequence % 2) != 0 || age == 0 || age > std::numeric_limits<std::size_t>::max() / 2)
+            return;
+    }
+    while (!slot.sequence.compare_exchange_weak(
+        sequence, writtenSequence(idx) - 1, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    // Odd sequence has to be visible before any field of the event changes.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& event = slot.event;
+    event.timestamp = (m_clock != nullptr) ? m_clock() : 0;
+    event.address = reinterpret_cast<std::uintptr_t>(ptr);
+    event.size = static_cast<std::uint32_t>(std::min<std::size_t>(size, std::numeric_limits<std::uint32_t>::max()));
+    event.threadId = (m_threadId != nullptr) ? m_threadId() : 0;
+    event.type = type;
+    event.reserved = 0;
+
+    slot.sequence.store(writtenSequence(idx), std::memory_order_release);
+}
+
+std::size_t Tracer::recordedCount() const
+{
+    return m_recorded.load(std::memory_order_relaxed);
+}
+
+std::size_t Tracer::exportSize() const
+{
+    return sizeof(TraceHeader) + std::min(recordedCount(), m_capacity) * sizeof(TraceEvent);
+}
+
+std::size_t Tracer::exportTrace(void* buffer, std::size_t size) const
+{
+    auto recorded = m_recorded.load(std::memory_order_relaxed);
+    auto slotsCount = std::min(recorded, m_capacity);
+    if (buffer == nullptr || size < sizeof(TraceHeader) + slotsCount * sizeof(TraceEvent))
+        return 0;
+
+    // When the buffer has wrapped, the oldest event is stored right after the newest one.
+    auto* output = utils::movePtr(static_cast<std::byte*>(buffer), sizeof(TraceHeader));
+    auto first = recorded - slotsCount;
+    std::size_t eventsCount = 0;
+    for (std::size_t i = 0; i < slotsCount; ++i) {
+        auto idx = first + i;
+        auto& slot = m_slots[idx & (m_capacity - 1)]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != writtenSequence(idx))
+            continue;
+
+        // Event is copied optimistically and kept only if its slot was not taken by another writer meanwhile.
+        std::memcpy(output, &slot.event, sizeof(TraceEvent));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        output = utils::movePtr(output, sizeof(TraceEvent));
+        ++eventsCount;
+    }
+
+    TraceHeader header{};
+    header.magic = {'L', 'A', 'T', 'R'};
+    header.version = 1;
+    header.eventSize = sizeof(TraceEvent);
+    header.eventsCount = eventsCount;
+    header.droppedCount = recorded - eventsCount;
+    std::memcpy(buffer, &header, sizeof(header));
+
+    return sizeof(TraceHeader) + eventsCount * sizeof(TraceEvent);
+}
+
+} // namespace memory
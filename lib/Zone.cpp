@@ -36,39 +36,40 @@
 #include "utils.hpp"
 
 #include <cassert>
+#include <cstdint>
 
 namespace memory {
 
 static_assert(Zone::isNaturallyAligned(), "class Zone is not naturally aligned");
 
-void Zone::init(Page* page, std::size_t pageSize, std::size_t chunkSize)
+void Zone::init(Page* page, std::size_t pageSize, std::size_t chunkSize, std::size_t offset)
 {
     assert(page);
     assert(pageSize);
     assert(chunkSize);
+    assert(offset < pageSize);
+    assert((pageSize - offset) / chunkSize <= maxChunksCount());
 
     clear();
 
     m_page = page;
-    m_chunkSize = chunkSize;
-    m_chunksCount = pageSize / chunkSize;
+    m_firstChunk = reinterpret_cast<Chunk*>(page->address() + offset);
+    m_bumpChunk = m_firstChunk;
+    m_chunkSize = std::uint32_t(chunkSize);
+    m_chunksCount = std::uint16_t((pageSize - offset) / chunkSize);
     m_freeChunksCount = m_chunksCount;
-
-    auto* chunk = reinterpret_cast<Chunk*>(page->address());
-    for (std::size_t i = 0; i < m_chunksCount; ++i, chunk = utils::movePtr(chunk, m_chunkSize)) {
-        chunk->initListNode();
-        chunk->addToList(&m_freeChunks);
-    }
 }
 
 void Zone::clear()
 {
     initListNode();
     m_page = nullptr;
+    m_firstChunk = nullptr;
+    m_bumpChunk = nullptr;
+    m_freeChunks = nullptr;
     m_chunkSize = 0;
     m_chunksCount = 0;
     m_freeChunksCount = 0;
-    m_freeChunks = nullptr;
 }
 
 Page* Zone::page()
@@ -95,8 +96,16 @@ Chunk* Zone::takeChunk()
 {
     assert(m_freeChunksCount);
 
-    auto* chunk = m_freeChunks;
-    chunk->removeFromList(&m_freeChunks);
+    Chunk* chunk{};
+    if (m_freeChunks != nullptr) {
+        chunk = m_freeChunks;
+        m_freeChunks = chunk->next;
+    }
+    else {
+        chunk = m_bumpChunk;
+        m_bumpChunk = utils::movePtr(m_bumpChunk, m_chunkSize);
+    }
+
     --m_freeChunksCount;
 
     return chunk;
@@ -106,19 +115,19 @@ void Zone::giveChunk(Chunk* chunk)
 {
     assert(chunk);
 
-    chunk->addToList(&m_freeChunks);
+    chunk->next = m_freeChunks;
+    m_freeChunks = chunk;
     ++m_freeChunksCount;
 }
 
 bool Zone::isValidChunk(Chunk* chunk)
 {
-    auto* it = reinterpret_cast<Chunk*>(m_page->address());
-    for (std::size_t i = 0; i < m_chunksCount; ++i, it = utils::movePtr(it, m_chunkSize)) {
-        if (it == chunk)
-            return true;
-    }
+    auto chunkAddr = reinterpret_cast<std::uintptr_t>(chunk);
+    auto firstAddr = reinterpret_cast<std::uintptr_t>(m_firstChunk);
+    if (chunkAddr < firstAddr || chunkAddr >= (firstAddr + m_chunksCount * m_chunkSize))
+        return false;
 
-    return false;
+    return ((chunkAddr - firstAddr) % m_chunkSize) == 0;
 }
 
 } // namespace memory
@@ -35,6 +35,8 @@
 #include "ListNode.hpp"
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 
 namespace memory {
 
@@ -42,7 +44,11 @@ class Page;
 
 /// Represents a memory chunk. Chunks are part of the zone.
 /// @note Each chunk has the size, which is a power of 2.
-class Chunk : public ListNode<Chunk> {};
+/// @note Free chunks are only pushed to and popped from the head of the free list, so they keep just the link to
+///       the next free chunk. This allows chunks as small as a single pointer.
+struct Chunk {
+    Chunk* next; ///< Next free chunk in the zone.
+};
 
 /// Represents a memory zone. Each zone consists of the memory chunks of equal size.
 class Zone : public ListNode<Zone> {
@@ -75,7 +81,10 @@ public:
     /// @param page         Page to be associated with this zone.
     /// @param pageSize     Size of the associated page.
     /// @param chunkSize    Size of the chunk to be used within this zone.
-    void init(Page* page, std::size_t pageSize, std::size_t chunkSize);
+    /// @param offset       Number of bytes at the beginning of the page, that should not be used for chunks.
+    /// @note Offset is expected to be a multiple of the chunk size, so that all chunks remain aligned to their size.
+    /// @note Chunks are not touched here. They are carved on demand by takeChunk(), so this function is O(1).
+    void init(Page* page, std::size_t pageSize, std::size_t chunkSize, std::size_t offset = 0);
 
     /// Clears the internal state of the zone.
     void clear();
@@ -99,6 +108,8 @@ public:
     /// Allocates the chunk from this zone and returns it.
     /// @return Allocated chunk.
     /// @note This function updates the 'free' counter.
+    /// @note Released chunks are reused first. Otherwise chunks, that have never been used, are carved
+    ///       from the zone in the address order.
     Chunk* takeChunk();
 
     /// Releases the given chunk.
@@ -122,17 +133,30 @@ public:
     {
         constexpr std::size_t cRequiredSize = sizeof(ListNode<Zone>) // Inherited fields
                                               + sizeof(m_page)       // NOLINT(bugprone-sizeof-expression)
-                                              + sizeof(m_chunkSize) + sizeof(m_chunksCount) + sizeof(m_freeChunksCount)
-                                              + sizeof(m_freeChunks); // NOLINT(bugprone-sizeof-expression)
+                                              + sizeof(m_firstChunk) // NOLINT(bugprone-sizeof-expression)
+                                              + sizeof(m_bumpChunk)  // NOLINT(bugprone-sizeof-expression)
+                                              + sizeof(m_freeChunks) // NOLINT(bugprone-sizeof-expression)
+                                              + sizeof(m_chunkSize) + sizeof(m_chunksCount) + sizeof(m_freeChunksCount);
         return (cRequiredSize == sizeof(Zone));
     }
 
+    /// Returns maximal number of chunks, that can be part of one zone.
+    /// @return Maximal number of chunks in one zone.
+    /// @note Chunk counters are kept in 16 bits, so that the zone descriptor fits in a single cache line.
+    static constexpr std::size_t maxChunksCount()
+    {
+        constexpr std::size_t cMaxChunksCount = std::numeric_limits<std::uint16_t>::max();
+        return cMaxChunksCount;
+    }
+
 private:
-    Page* m_page{};                  ///< Page, that is associated with this zone.
-    std::size_t m_chunkSize{};       ///< Size of the chunks, that are part of this zone.
-    std::size_t m_chunksCount{};     ///< Number of chunks in this zone.
-    std::size_t m_freeChunksCount{}; ///< Number of free chunks in this zone.
-    Chunk* m_freeChunks{};           ///< List of free chunks in this zone.
+    Page* m_page{};                    ///< Page, that is associated with this zone.
+    Chunk* m_firstChunk{};             ///< First chunk in this zone.
+    Chunk* m_bumpChunk{};              ///< First chunk in this zone, that has never been allocated.
+    Chunk* m_freeChunks{};             ///< Singly linked list of chunks, that were allocated and then released.
+    std::uint32_t m_chunkSize{};       ///< Size of the chunks, that are part of this zone.
+    std::uint16_t m_chunksCount{};     ///< Number of chunks in this zone.
+    std::uint16_t m_freeChunksCount{}; ///< Number of free chunks in this zone.
 };
 
 } // namespace memory
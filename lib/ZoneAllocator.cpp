@@ -37,7 +37,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <numeric>
 
 namespace memory {
 
@@ -50,11 +49,14 @@ bool ZoneAllocator::init(PageAllocator* pageAllocator, std::size_t pageSize)
 {
     clear();
 
+    if (pageSize / minimalAllocSize() > Zone::maxChunksCount())
+        return false;
+
     m_pageAllocator = pageAllocator;
     m_pageSize = pageSize;
     m_zoneDescChunkSize = detail::chunkSize(sizeof(Zone));
     m_zoneDescIdx = detail::zoneIdx(m_zoneDescChunkSize);
-    if (!initZone(&m_initialZone, m_zoneDescChunkSize))
+    if (!initZone(&m_initialZone, m_zoneDescChunkSize, 0, Tier::eFast, Caps::eNone))
         return false;
 
     addZone(&m_initialZone);
@@ -67,27 +69,105 @@ void ZoneAllocator::clear()
     m_pageSize = 0;
     m_zoneDescChunkSize = 0;
     m_zoneDescIdx = 0;
+    m_policy = ZonePolicy::eFirstFit;
+    m_colouring = false;
+    m_maxRefillPagesCount = 1;
     m_initialZone.clear();
     m_zones.fill({});
 }
 
+void ZoneAllocator::setPolicy(ZonePolicy policy)
+{
+    m_policy = policy;
+
+    // Partially used zones are moved to the lists of the new policy. Each list is moved from its tail, so that
+    // zones keep their order in the list.
+    for (auto& zoneInfo : m_zones) {
+        auto partial = zoneInfo.partial;
+        zoneInfo.partial.fill(nullptr);
+        for (auto& head : partial) {
+            auto* zone = head;
+            while (zone != nullptr && zone->next() != nullptr)
+                zone = zone->next();
+
+            while (zone != nullptr) {
+                auto* prev = zone->prev();
+                zone->removeFromList(&head);
+                zone->addToList(zoneList(zone));
+                zone = prev;
+            }
+        }
+    }
+}
+
+void ZoneAllocator::setColouring(bool enabled)
+{
+    m_colouring = enabled;
+}
+
+void ZoneAllocator::setGrowth(std::size_t maxPagesCount)
+{
+    m_maxRefillPagesCount = std::max<std::size_t>(maxPagesCount, 1);
+    for (std::size_t idx = 0; idx < m_zones.size(); ++idx) {
+        auto& zoneInfo = m_zones.at(idx);
+        zoneInfo.refillPagesCount = std::min(zoneInfo.refillPagesCount, m_maxRefillPagesCount);
+        trimSparePages(idx);
+    }
+}
+
 void* ZoneAllocator::allocate(std::size_t size)
 {
-    if (size == 0)
-        return nullptr;
+    return allocateBlock(size, defaultTier(size), Caps::eNone, 0);
+}
+
+void* ZoneAllocator::allocate(std::size_t size, Tier tier)
+{
+    return allocateBlock(size, tier, Caps::eNone, 0);
+}
+
+void* ZoneAllocator::allocate(std::size_t size, Caps caps, std::size_t boundary)
+{
+    return allocateBlock(size, defaultTier(size), caps, boundary);
+}
+
+void* ZoneAllocator::allocateFromSizeClass(std::size_t idx, std::size_t size)
+{
+    if (size == 0 || m_pageAllocator == nullptr || idx >= m_cMaxZoneIdx || (minimalAllocSize() << idx) >= m_pageSize)
+        return allocate(size);
+
+    assert(idx == detail::zoneIdx(detail::chunkSize(size)));
+    return allocateFromZones(idx, defaultTier(size), Caps::eNone);
+}
+
+bool ZoneAllocator::reserve(std::size_t size, std::size_t count)
+{
+    if (size == 0 || m_pageAllocator == nullptr || usePages(size))
+        return false;
 
     std::size_t allocSize = detail::chunkSize(size);
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(allocSize));
+    auto pinnedChunksCount = zoneInfo.pinnedChunksCount;
+    while (zoneInfo.pinnedChunksCount < zoneInfo.reservedChunksCount + count) {
+        if (allocateZone(allocSize, defaultTier(size), Caps::eNone, true) != nullptr)
+            continue;
 
-    if (size >= m_pageSize || allocSize >= m_pageSize) {
-        auto pageCount = static_cast<std::size_t>(std::ceil(double(size) / double(m_pageSize)));
-        if (auto* page = m_pageAllocator->allocate(pageCount))
-            return reinterpret_cast<void*>(page->address());
+        // Zones pinned by this call are still empty and lie at the head of the list, so they can be rolled back.
+        while (zoneInfo.pinnedChunksCount != pinnedChunksCount)
+            destroyZone(zoneInfo.pinned);
 
-        return nullptr;
+        return false;
     }
 
-    std::size_t idx = detail::zoneIdx(allocSize);
-    Zone* zone = shouldAllocateZone(idx) ? allocateZone(allocSize) : getFreeZone(idx);
+    zoneInfo.reservedChunksCount += count;
+    return true;
+}
+
+void* ZoneAllocator::allocateReserved(std::size_t size)
+{
+    if (size == 0 || m_pageAllocator == nullptr || usePages(size))
+        return nullptr;
+
+    auto* zone = m_zones.at(detail::zoneIdx(detail::chunkSize(size))).pinned;
     if (zone == nullptr)
         return nullptr;
 
@@ -96,7 +176,7 @@ void* ZoneAllocator::allocate(std::size_t size)
 
 void ZoneAllocator::release(void* ptr)
 {
-    if (ptr == nullptr)
+    if (ptr == nullptr || m_pageAllocator == nullptr)
         return;
 
     if (deallocateChunk(ptr))
@@ -108,75 +188,243 @@ void ZoneAllocator::release(void* ptr)
 
 ZoneAllocator::Stats ZoneAllocator::getStats()
 {
-    auto* start = std::begin(m_zones);
-    auto* end = std::end(m_zones);
+    std::size_t usedZonesCount = 0;
+    std::size_t reservedMemorySize = 0;
+    std::size_t freeMemorySize = 0;
+    std::size_t sparePagesCount = 0;
+    for (std::size_t idx = 0; idx < m_zones.size(); ++idx) {
+        const auto& zoneInfo = m_zones.at(idx);
+        usedZonesCount += zoneInfo.zonesCount;
+        reservedMemorySize += zoneInfo.reservedMemorySize;
+        freeMemorySize += zoneInfo.freeChunksCount * (minimalAllocSize() << idx);
+        sparePagesCount += zoneInfo.sparePagesCount;
+    }
 
-    // clang-format off
-    std::size_t usedZonesCount = std::accumulate(start, end, 0U, [](const size_t& sum, const ZoneInfo& zoneInfo) {
-        std::size_t count = 0;
-        for (auto* zone = zoneInfo.head; zone != nullptr; zone = zone->next(), ++count);
-        return sum + count;
-    });
-    // clang-format on
+    // Spare pages are taken from the PageAllocator, but hold no chunks yet, so they count as used and free at once.
+    freeMemorySize += sparePagesCount * m_pageSize;
 
     Stats stats{};
-    stats.usedMemorySize = usedZonesCount * m_pageSize;
-    stats.reservedMemorySize = (usedZonesCount > 0) ? (usedZonesCount - 1) * m_zoneDescChunkSize : 0;
-    stats.freeMemorySize = std::accumulate(start, end, 0U, [](const size_t& sum, const ZoneInfo& zoneInfo) {
-        if (zoneInfo.head == nullptr)
-            return sum;
-
-        return sum + (zoneInfo.head->chunkSize() * zoneInfo.freeChunksCount);
-    });
+    stats.usedMemorySize = (usedZonesCount + sparePagesCount) * m_pageSize;
+    stats.reservedMemorySize = reservedMemorySize;
+    stats.freeMemorySize = freeMemorySize;
     stats.allocatedMemorySize = stats.usedMemorySize - stats.reservedMemorySize - stats.freeMemorySize;
 
     return stats;
 }
 
+std::size_t ZoneAllocator::getSizeClassStats(
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount>& sizeClassStats)
+{
+    sizeClassStats.fill({});
+
+    std::size_t count = 0;
+    for (; count < m_zones.size() && (minimalAllocSize() << count) < m_pageSize; ++count) {
+        const auto& zoneInfo = m_zones.at(count);
+        auto& stats = sizeClassStats.at(count);
+        stats.chunkSize = minimalAllocSize() << count;
+        stats.zonesCount = zoneInfo.zonesCount;
+        stats.liveChunksCount = zoneInfo.chunksCount - zoneInfo.freeChunksCount;
+        stats.peakChunksCount = zoneInfo.peakUsedChunksCount;
+        stats.allocationsCount = zoneInfo.allocationsCount;
+        stats.releasesCount = zoneInfo.releasesCount;
+        stats.wastedMemorySize = zoneInfo.reservedMemorySize + zoneInfo.freeChunksCount * stats.chunkSize
+                               + zoneInfo.sparePagesCount * m_pageSize;
+        stats.reservedChunksCount = zoneInfo.reservedChunksCount;
+        stats.pinnedChunksCount = zoneInfo.pinnedChunksCount;
+        stats.sparePagesCount = zoneInfo.sparePagesCount;
+    }
+
+    return count;
+}
+
+void* ZoneAllocator::allocateBlock(std::size_t size, Tier tier, Caps caps, std::size_t boundary)
+{
+    if (size == 0 || m_pageAllocator == nullptr)
+        return nullptr;
+
+    if (usePages(size)) {
+        auto pageCount = static_cast<std::size_t>(std::ceil(double(size) / double(m_pageSize)));
+        if (auto* page = m_pageAllocator->allocate(pageCount, tier, caps, boundary))
+            return reinterpret_cast<void*>(page->address());
+
+        return nullptr;
+    }
+
+    std::size_t allocSize = detail::chunkSize(size);
+    if (boundary != 0 && (!utils::isPowerOf2(boundary) || allocSize > boundary))
+        return nullptr;
+
+    return allocateFromZones(detail::zoneIdx(allocSize), tier, caps);
+}
+
+void* ZoneAllocator::allocateFromZones(std::size_t idx, Tier tier, Caps caps)
+{
+    std::size_t allocSize = minimalAllocSize() << idx;
+    Zone* zone{};
+    if (caps == Caps::eNone)
+        zone = shouldAllocateZone(idx) ? allocateZone(allocSize, tier, caps) : getFreeZone(idx);
+    else if ((zone = getFreeZone(idx, caps)) == nullptr)
+        zone = allocateZone(allocSize, tier, caps);
+
+    if (zone == nullptr)
+        return nullptr;
+
+    return allocateChunk<void>(zone);
+}
+
+Tier ZoneAllocator::defaultTier(std::size_t size) const
+{
+    // Zones are shared by many small, frequently used chunks, so they benefit the most from fast memory.
+    return usePages(size) ? Tier::eNormal : Tier::eFast;
+}
+
+Chunk* ZoneAllocator::takeChunk(Zone* zone)
+{
+    assert(zone);
+
+    auto** list = zoneList(zone);
+    auto* chunk = zone->takeChunk();
+
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(zone->chunkSize()));
+    --zoneInfo.freeChunksCount;
+    ++zoneInfo.allocationsCount;
+    if (zone->page()->isPinned())
+        --zoneInfo.pinnedFreeChunksCount;
+
+    auto usedChunksCount = zoneInfo.chunksCount - zoneInfo.freeChunksCount;
+    zoneInfo.peakUsedChunksCount = std::max(zoneInfo.peakUsedChunksCount, usedChunksCount);
+
+    if (auto** newList = zoneList(zone); newList != list) {
+        zone->removeFromList(list);
+        zone->addToList(newList);
+    }
+
+    return chunk;
+}
+
+void ZoneAllocator::giveChunk(Zone* zone, Chunk* chunk)
+{
+    assert(zone);
+
+    auto** list = zoneList(zone);
+    zone->giveChunk(chunk);
+
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(zone->chunkSize()));
+    ++zoneInfo.freeChunksCount;
+    ++zoneInfo.releasesCount;
+    if (zone->page()->isPinned())
+        ++zoneInfo.pinnedFreeChunksCount;
+
+    if (auto** newList = zoneList(zone); newList != list) {
+        zone->removeFromList(list);
+        zone->addToList(newList);
+    }
+}
+
 Zone* ZoneAllocator::getFreeZone(std::size_t idx)
 {
-    Zone* zone = nullptr;
-    for (zone = m_zones.at(idx).head; zone != nullptr; zone = zone->next()) {
-        if (zone->freeChunksCount() > 0)
-            break;
+    auto& zoneInfo = m_zones.at(idx);
+
+    if (m_policy == ZonePolicy::eFullestFirst) {
+        for (auto it = zoneInfo.partial.rbegin(); it != zoneInfo.partial.rend(); ++it) {
+            if (*it != nullptr)
+                return *it;
+        }
+    }
+    else if (auto* zone = zoneInfo.partial.front()) {
+        return zone;
+    }
+
+    return zoneInfo.empty;
+}
+
+Zone* ZoneAllocator::getFreeZone(std::size_t idx, Caps caps)
+{
+    if (caps == Caps::eNone)
+        return getFreeZone(idx);
+
+    for (auto* head : m_zones.at(idx).heads()) {
+        for (auto* zone = head; zone != nullptr; zone = zone->next()) {
+            auto* page = zone->page();
+            if (zone->freeChunksCount() != 0 && !page->isPinned() && hasCaps(m_pageAllocator->getCaps(page), caps))
+                return zone;
+        }
     }
 
-    return zone;
+    return nullptr;
+}
+
+bool ZoneAllocator::usePages(std::size_t size) const
+{
+    std::size_t allocSize = detail::chunkSize(size);
+
+    // Pages bigger than the largest size class leave sizes without a zone, so those are served with whole pages too.
+    return (size >= m_pageSize || allocSize >= m_pageSize || detail::zoneIdx(allocSize) >= m_cMaxZoneIdx);
 }
 
 bool ZoneAllocator::shouldAllocateZone(std::size_t idx)
 {
-    std::size_t triggerCount = (idx == m_zoneDescIdx) ? 1 : 0;
-    return (m_zones.at(idx).freeChunksCount == triggerCount);
+    const auto& zoneInfo = m_zones.at(idx);
+    return (zoneInfo.freeChunksCount == zoneInfo.pinnedFreeChunksCount);
 }
 
-Zone* ZoneAllocator::allocateZone(std::size_t chunkSize) // NOLINT(misc-no-recursion)
+bool ZoneAllocator::useOnPageHeader(std::size_t chunkSize) const
 {
-    if (chunkSize != m_zoneDescChunkSize && shouldAllocateZone(m_zoneDescIdx)) {
-        if (allocateZone(m_zoneDescChunkSize) == nullptr)
-            return nullptr;
-    }
+    return (chunkSize <= m_zoneDescChunkSize);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+Zone* ZoneAllocator::allocateZone(std::size_t chunkSize, Tier tier, Caps caps, bool pinned)
+{
+    auto* zone = useOnPageHeader(chunkSize) ? allocateOnPageZone(chunkSize, tier, caps)
+                                            : allocateOffPageZone(chunkSize, tier, caps);
+    if (zone == nullptr)
+        return nullptr;
+
+    zone->page()->setPinned(pinned);
+    addZone(zone);
+    return zone;
+}
 
-    auto* zone = getFreeZone(m_zoneDescIdx);
+Zone* ZoneAllocator::allocateOnPageZone(std::size_t chunkSize, Tier tier, Caps caps)
+{
+    auto* page = allocateZonePage(chunkSize, tier, caps);
+    if (page == nullptr)
+        return nullptr;
+
+    auto* zone = reinterpret_cast<Zone*>(page->address());
+    zone->init(page, m_pageSize, chunkSize, utils::alignUp(sizeof(Zone), chunkSize) + nextColourOffset(chunkSize));
+    page->setZoneHeader(true);
+    return zone;
+}
+
+Zone* ZoneAllocator::allocateOffPageZone(std::size_t chunkSize, Tier tier, Caps caps) // NOLINT(misc-no-recursion)
+{
+    assert(!useOnPageHeader(chunkSize));
+
+    // Zone descriptors use on-page headers, so this never recurses more than once.
+    auto* descZone = shouldAllocateZone(m_zoneDescIdx) ? allocateZone(m_zoneDescChunkSize, Tier::eFast, Caps::eNone)
+                                                       : getFreeZone(m_zoneDescIdx);
+    if (descZone == nullptr)
+        return nullptr;
+
+    auto* zone = allocateChunk<Zone>(descZone);
     assert(zone);
-    auto* newZone = allocateChunk<Zone>(zone);
-    assert(newZone);
 
-    if (!initZone(newZone, chunkSize)) {
-        deallocateChunk(newZone);
+    if (!initZone(zone, chunkSize, nextColourOffset(chunkSize), tier, caps)) {
+        deallocateChunk(zone);
         return nullptr;
     }
 
-    addZone(newZone);
-    return newZone;
+    return zone;
 }
 
-bool ZoneAllocator::initZone(Zone* zone, std::size_t chunkSize)
+bool ZoneAllocator::initZone(Zone* zone, std::size_t chunkSize, std::size_t offset, Tier tier, Caps caps)
 {
     assert(zone);
 
-    if (auto* page = m_pageAllocator->allocate(1)) {
-        zone->init(page, m_pageSize, chunkSize);
+    if (auto* page = allocateZonePage(chunkSize, tier, caps)) {
+        zone->init(page, m_pageSize, chunkSize, offset);
         return true;
     }
 
@@ -187,17 +435,143 @@ void ZoneAllocator::clearZone(Zone* zone)
 {
     assert(zone);
 
-    m_pageAllocator->release(zone->page());
+    // Zone has to be cleared before releasing the page, because its header can be stored on that page.
+    auto* page = zone->page();
+    auto chunkSize = zone->chunkSize();
     zone->clear();
+    page->setZoneHeader(false);
+    page->setPinned(false);
+    releaseZonePage(chunkSize, page);
+}
+
+Page* ZoneAllocator::allocateZonePage(std::size_t chunkSize, Tier tier, Caps caps)
+{
+    if (caps != Caps::eNone || tier != defaultTier(chunkSize))
+        return m_pageAllocator->allocate(1, tier, caps);
+
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(chunkSize));
+    if (auto* page = zoneInfo.sparePages) {
+        zoneInfo.idleReleasesCount = 0;
+        page->removeFromList(&zoneInfo.sparePages);
+        --zoneInfo.sparePagesCount;
+        return page;
+    }
+
+    // Smaller batches are tried when the PageAllocator cannot provide the whole one.
+    auto count = zoneInfo.refillPagesCount;
+    auto* pages = m_pageAllocator->allocateSeparate(count, tier, caps);
+    while (pages == nullptr && count > 1) {
+        count /= 2;
+        pages = m_pageAllocator->allocateSeparate(count, tier, caps);
+    }
+
+    if (pages == nullptr)
+        return nullptr;
+
+    zoneInfo.idleReleasesCount = 0;
+
+    // Spare pages are stacked in reverse, so that the following zones are created in the address order.
+    for (auto i = count - 1; i > 0; --i) {
+        auto* page = m_pageAllocator->getPage(pages->address() + i * m_pageSize);
+        assert(page);
+        page->addToList(&zoneInfo.sparePages);
+        ++zoneInfo.sparePagesCount;
+    }
+
+    zoneInfo.refillPagesCount = std::min(zoneInfo.refillPagesCount * 2, m_maxRefillPagesCount);
+    return pages;
+}
+
+void ZoneAllocator::releaseZonePage(std::size_t chunkSize, Page* page)
+{
+    auto idx = detail::zoneIdx(chunkSize);
+    auto& zoneInfo = m_zones.at(idx);
+
+    // Batch is shrunk only after a whole batch of zones was released without creating any new one in between, so
+    // size classes with steady churn keep their batch and reuse the spare pages.
+    if (++zoneInfo.idleReleasesCount >= zoneInfo.refillPagesCount) {
+        zoneInfo.refillPagesCount = std::max<std::size_t>(zoneInfo.refillPagesCount / 2, 1);
+        zoneInfo.idleReleasesCount = 0;
+    }
+
+    // Only pages, that could be returned by allocateZonePage() for this size class, are kept.
+    bool spare = zoneInfo.sparePagesCount + 1 < zoneInfo.refillPagesCount
+              && m_pageAllocator->getTier(page) == defaultTier(chunkSize)
+              && m_pageAllocator->getCaps(page) == Caps::eNone;
+    if (spare) {
+        page->addToList(&zoneInfo.sparePages);
+        ++zoneInfo.sparePagesCount;
+    }
+    else {
+        m_pageAllocator->release(page);
+    }
+
+    trimSparePages(idx);
+}
+
+void ZoneAllocator::trimSparePages(std::size_t idx)
+{
+    auto& zoneInfo = m_zones.at(idx);
+    while (zoneInfo.sparePagesCount + 1 > zoneInfo.refillPagesCount) {
+        auto* page = zoneInfo.sparePages;
+        page->removeFromList(&zoneInfo.sparePages);
+        --zoneInfo.sparePagesCount;
+        m_pageAllocator->release(page);
+    }
+}
+
+bool ZoneAllocator::destroyZone(Zone* zone) // NOLINT(misc-no-recursion)
+{
+    assert(zone);
+
+    bool hasOnPageHeader = zone->page()->hasZoneHeader();
+    removeZone(zone);
+    clearZone(zone);
+
+    // Zones with on-page headers are released together with their page.
+    return hasOnPageHeader || deallocateChunk(zone);
+}
+
+std::size_t ZoneAllocator::nextColourOffset(std::size_t chunkSize)
+{
+    if (!m_colouring)
+        return 0;
+
+    auto colourSize = std::max(chunkSize, m_cCacheLineSize);
+    auto coloursCount = (m_pageSize / m_cMaxColourRatio) / colourSize + 1;
+
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(chunkSize));
+    auto colour = zoneInfo.nextColour % coloursCount;
+    zoneInfo.nextColour = colour + 1;
+
+    return colour * colourSize;
+}
+
+std::size_t ZoneAllocator::zoneOverheadSize(Zone* zone)
+{
+    assert(zone);
+
+    auto overheadSize = m_pageSize - zone->chunksCount() * zone->chunkSize();
+    if (zone == &m_initialZone || zone->page()->hasZoneHeader())
+        return overheadSize;
+
+    return overheadSize + m_zoneDescChunkSize;
 }
 
 void ZoneAllocator::addZone(Zone* zone)
 {
     assert(zone);
 
-    auto idx = detail::zoneIdx(zone->chunkSize());
-    zone->addToList(&m_zones.at(idx).head);
-    m_zones.at(idx).freeChunksCount += zone->freeChunksCount();
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(zone->chunkSize()));
+    zone->addToList(zoneList(zone));
+    ++zoneInfo.zonesCount;
+    zoneInfo.chunksCount += zone->chunksCount();
+    zoneInfo.freeChunksCount += zone->freeChunksCount();
+    zoneInfo.reservedMemorySize += zoneOverheadSize(zone);
+    if (zone->page()->isPinned()) {
+        zoneInfo.pinnedChunksCount += zone->chunksCount();
+        zoneInfo.pinnedFreeChunksCount += zone->freeChunksCount();
+    }
 }
 
 void ZoneAllocator::removeZone(Zone* zone)
@@ -205,9 +579,39 @@ void ZoneAllocator::removeZone(Zone* zone)
     assert(zone);
     assert(zone != &m_initialZone);
 
-    auto idx = detail::zoneIdx(zone->chunkSize());
-    zone->removeFromList(&m_zones.at(idx).head);
-    m_zones.at(idx).freeChunksCount -= zone->freeChunksCount();
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(zone->chunkSize()));
+    zone->removeFromList(zoneList(zone));
+    --zoneInfo.zonesCount;
+    zoneInfo.chunksCount -= zone->chunksCount();
+    zoneInfo.freeChunksCount -= zone->freeChunksCount();
+    zoneInfo.reservedMemorySize -= zoneOverheadSize(zone);
+    if (zone->page()->isPinned()) {
+        zoneInfo.pinnedChunksCount -= zone->chunksCount();
+        zoneInfo.pinnedFreeChunksCount -= zone->freeChunksCount();
+    }
+}
+
+Zone** ZoneAllocator::zoneList(Zone* zone)
+{
+    assert(zone);
+
+    auto& zoneInfo = m_zones.at(detail::zoneIdx(zone->chunkSize()));
+    if (zone->page()->isPinned())
+        return (zone->freeChunksCount() == 0) ? &zoneInfo.pinnedFull : &zoneInfo.pinned;
+
+    if (zone->freeChunksCount() == 0)
+        return &zoneInfo.full;
+
+    if (zone->freeChunksCount() == zone->chunksCount())
+        return &zoneInfo.empty;
+
+    // First-fit keeps all partially used zones in one list, so that zones don't change their order on each chunk.
+    if (m_policy == ZonePolicy::eFirstFit)
+        return &zoneInfo.partial.front();
+
+    auto usedChunksCount = zone->chunksCount() - zone->freeChunksCount();
+    auto bucket = (usedChunksCount * m_cOccupancyBucketsCount) / zone->chunksCount();
+    return &zoneInfo.partial.at(bucket);
 }
 
 Zone* ZoneAllocator::findZone(Chunk* chunk)
@@ -215,12 +619,23 @@ Zone* ZoneAllocator::findZone(Chunk* chunk)
     assert(chunk);
 
     auto chunkAddr = reinterpret_cast<std::uintptr_t>(chunk);
-    auto pageAddr = chunkAddr & ~(m_pageSize - 1);
+    auto* page = m_pageAllocator->getPage(chunkAddr);
+    if (page == nullptr || !page->isUsed())
+        return nullptr;
 
-    for (auto& zoneInfo : m_zones) {
-        for (auto* zone = zoneInfo.head; zone != nullptr; zone = zone->next()) {
-            if (zone->page()->address() == pageAddr && zone->isValidChunk(chunk))
-                return zone;
+    if (page->hasZoneHeader()) {
+        auto* zone = reinterpret_cast<Zone*>(page->address());
+        return zone->isValidChunk(chunk) ? zone : nullptr;
+    }
+
+    // Zones with off-page headers can be found only by scanning the zones, that are big enough to use them.
+    for (auto idx = m_zoneDescIdx; idx < m_zones.size(); ++idx) {
+        const auto& zoneInfo = m_zones.at(idx);
+        for (auto* head : zoneInfo.heads()) {
+            for (auto* zone = head; zone != nullptr; zone = zone->next()) {
+                if (zone->page() == page && zone->isValidChunk(chunk))
+                    return zone;
+            }
         }
     }
 
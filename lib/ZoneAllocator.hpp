@@ -32,9 +32,14 @@
 
 #pragma once
 
+#include "Page.hpp"
 #include "Zone.hpp"
 #include "utils.hpp"
 
+#include <allocator/Region.hpp>
+#include <allocator/Stats.hpp>
+#include <allocator/ZonePolicy.hpp>
+
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -72,15 +77,86 @@ public:
     [[nodiscard]] bool init(PageAllocator* pageAllocator, std::size_t pageSize);
 
     /// Clears the ZoneAllocator internal state.
+    /// @note This function restores the default zone selection policy.
     void clear();
 
+    /// Sets the policy of selecting zones, from which chunks are allocated.
+    /// @param policy               Policy to be used.
+    void setPolicy(ZonePolicy policy);
+
+    /// Enables or disables colouring of the newly created zones.
+    /// @param enabled              Flag indicating if colouring should be enabled.
+    /// @note Coloured zones start their chunks at rotating, cache line sized offsets, so that the first chunks of
+    ///       different zones don't compete for the same cache sets. This costs at most 1/8 of each zone page.
+    void setColouring(bool enabled);
+
+    /// Sets the maximal number of pages taken at once for the new zones of one size class.
+    /// @param maxPagesCount        Maximal number of pages taken at once. Value 1 disables the adaptive growth.
+    /// @note Each time a size class runs out of free chunks, the number of pages taken for it from the PageAllocator
+    ///       is doubled up to the given limit. Pages not used immediately are kept as spare pages of that class and
+    ///       are turned into zones on the following refills without touching the PageAllocator. Releasing as many
+    ///       zones as the current batch size, without taking any zone page in between, halves the number again, so
+    ///       idle size classes return their spare pages, while size classes with steady churn keep their batch.
+    void setGrowth(std::size_t maxPagesCount);
+
     /// Allocates the memory chunk of at least given size.
     /// @param size                 Size of the demanded memory chunk.
     /// @return Result of the allocation.
     /// @retval void*               Pointer to the allocated memory chunk on success.
     /// @retval nullptr             Some error occurred.
+    /// @note New zones are placed in fast memory first, while whole pages are taken from the normal one first.
     [[nodiscard]] void* allocate(std::size_t size);
 
+    /// Allocates the memory chunk of at least given size, preferring the given memory tier.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @param tier                 Tier of the memory, from which new pages should be taken first.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Zones are shared by all chunks of the same size, so for chunks served from zones the tier only selects
+    ///       the placement of new zones. Free chunks of existing zones are used regardless of their tier.
+    [[nodiscard]] void* allocate(std::size_t size, Tier tier);
+
+    /// Allocates the memory chunk of at least given size from memory with the given capabilities.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @param caps                 Capabilities demanded from the memory region of the chunk.
+    /// @param boundary             Address boundary, that the chunk must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Chunks are aligned to their power of 2 size, so they never cross boundaries not smaller than the chunk.
+    ///       Sizes bigger than the boundary can't be satisfied.
+    [[nodiscard]] void* allocate(std::size_t size, Caps caps, std::size_t boundary);
+
+    /// Allocates the memory chunk of at least given size from the given size class.
+    /// @param idx                  Index of the size class, to which the given size belongs.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Size class indexes not served from zones make this function equivalent to allocate(std::size_t).
+    [[nodiscard]] void* allocateFromSizeClass(std::size_t idx, std::size_t size);
+
+    /// Pre-creates zones pinned for the reserved allocations of chunks with the given size.
+    /// @param size                 Size of the reserved memory chunks.
+    /// @param count                Number of chunks, that have to be available to the reserved allocations.
+    /// @return Result of the reservation.
+    /// @retval true                Zones have been created and pinned.
+    /// @retval false               Some error occurred. No new zones are pinned in this case.
+    /// @note Reservations with the same chunk size add up. Pinned zones are never released and their chunks are
+    ///       never given to other allocations, so reserved allocations can't be starved by the rest of the system.
+    /// @note Only sizes served from zones can be reserved.
+    [[nodiscard]] bool reserve(std::size_t size, std::size_t count);
+
+    /// Allocates the memory chunk of at least given size from zones pinned for the reserved allocations.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note This function never takes pages from the PageAllocator. It fails only if the reservation for the given
+    ///       size is exceeded.
+    [[nodiscard]] void* allocateReserved(std::size_t size);
+
     /// Releases the given memory chunk.
     /// @param ptr                  Pointer to the memory chunk to be released.
     /// @note This function accepts nullptr input.
@@ -90,15 +166,47 @@ public:
     /// @return ZoneAllocator statistics.
     Stats getStats();
 
+    /// Returns the current statistics of each size class, that can be allocated from zones.
+    /// @param sizeClassStats       Array to be filled with the statistics of the size classes.
+    /// @return Number of valid entries in the given array.
+    std::size_t getSizeClassStats(
+        std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount>& sizeClassStats);
+
     /// Returns minimal size of chunk, that can be allocated.
     /// @return Minimal size of chunk, that can be allocated.
     static constexpr std::size_t minimalAllocSize()
     {
-        constexpr std::size_t cMinimalAllocSize = 16;
+        // Heap computes the size class indices on its own, so both have to start from the same chunk size.
+        constexpr std::size_t cMinimalAllocSize = allocator::cMinSizeClassChunkSize;
+        static_assert(sizeof(Chunk) <= cMinimalAllocSize, "free chunk doesn't fit in the minimal chunk");
         return cMinimalAllocSize;
     }
 
 private:
+    /// Allocates the memory chunk of at least given size, that satisfies all the given constraints.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @param tier                 Tier of the memory, from which new pages should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the chunk.
+    /// @param boundary             Address boundary, that the chunk must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    void* allocateBlock(std::size_t size, Tier tier, Caps caps, std::size_t boundary);
+
+    /// Allocates the memory chunk from zones with the given index.
+    /// @param idx                  Index of the zones, from which chunk should be allocated.
+    /// @param tier                 Tier of the memory, from which new zone pages should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the chunk.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    void* allocateFromZones(std::size_t idx, Tier tier, Caps caps);
+
+    /// Returns the tier, from which new pages for the memory block with the given size are taken by default.
+    /// @param size                 Size of the demanded memory block.
+    /// @return Default tier of the memory block.
+    [[nodiscard]] Tier defaultTier(std::size_t size) const;
+
     /// Allocates memory chunk from the given zone.
     /// @param zone                 Zone from which chunk should be allocated.
     /// @return Allocated memory chunk.
@@ -106,9 +214,7 @@ private:
     template <typename T>
     T* allocateChunk(Zone* zone)
     {
-        std::size_t idx = detail::zoneIdx(zone->chunkSize());
-        m_zones.at(idx).freeChunksCount--;
-        return reinterpret_cast<T*>(zone->takeChunk());
+        return reinterpret_cast<T*>(takeChunk(zone));
     }
 
     /// Deallocates memory chunk to the given zone.
@@ -125,53 +231,147 @@ private:
         if (!zone)
             return false;
 
-        std::size_t idx = detail::zoneIdx(zone->chunkSize());
-        m_zones.at(idx).freeChunksCount++;
-        zoneChunk->initListNode();
-        zone->giveChunk(zoneChunk);
+        giveChunk(zone, zoneChunk);
 
-        if (zone->chunksCount() == zone->freeChunksCount() && zone != &m_initialZone) {
-            removeZone(zone);
-            clearZone(zone);
-            return deallocateChunk(zone);
-        }
+        if (zone->chunksCount() == zone->freeChunksCount() && zone != &m_initialZone && !zone->page()->isPinned())
+            return destroyZone(zone);
 
         return true;
     }
 
+    /// Removes the given zone from the array of known zones, releases its page and its descriptor.
+    /// @param zone                 Zone to be destroyed.
+    /// @return Result of the zone destruction.
+    /// @retval true                Zone has been destroyed.
+    /// @retval false               Descriptor of the zone has not been deallocated.
+    bool destroyZone(Zone* zone);
+
+    /// Takes a free chunk from the given zone and moves the zone to the proper list, if its state has changed.
+    /// @param zone                 Zone from which chunk should be taken.
+    /// @return Taken chunk.
+    Chunk* takeChunk(Zone* zone);
+
+    /// Gives the chunk back to the given zone and moves the zone to the proper list, if its state has changed.
+    /// @param zone                 Zone to which chunk should be given.
+    /// @param chunk                Chunk to be given.
+    void giveChunk(Zone* zone, Chunk* chunk);
+
     /// Returns the Zone from the given array index, that has at least one free chunk.
     /// @param idx                  Index from which Zone should be taken.
     /// @return Result of the search.
     /// @retval Zone*               Pointer to the Zone on success.
     /// @retval nullptr             No free zone was found.
+    /// @note Partially used zones are preferred over the empty ones. Selection among them depends on the policy.
     Zone* getFreeZone(std::size_t idx);
 
-    /// Checks if there is the minimal required number of free chunks in the zone at given array index.
+    /// Returns the Zone from the given array index, that has at least one free chunk and whose page is placed in
+    /// memory with the given capabilities.
+    /// @param idx                  Index from which Zone should be taken.
+    /// @param caps                 Capabilities demanded from the memory region of the zone.
+    /// @return Result of the search.
+    /// @retval Zone*               Pointer to the Zone on success.
+    /// @retval nullptr             No matching zone was found.
+    /// @note Zones are scanned linearly, unless no capabilities are demanded. Pinned zones are never returned.
+    Zone* getFreeZone(std::size_t idx, Caps caps);
+
+    /// Checks if memory block with the given size should be allocated as whole pages instead of a zone chunk.
+    /// @param size                 Size of the demanded memory block.
+    /// @return Flag indicating if whole pages should be used.
+    /// @retval true                Memory block should be allocated as whole pages.
+    /// @retval false               Memory block should be allocated from a zone.
+    [[nodiscard]] bool usePages(std::size_t size) const;
+
+    /// Checks if there is the minimal required number of free chunks, that are not pinned, in the zone at given
+    /// array index.
     /// @param idx                  Index to be checked.
     /// @return Flag indicating if a new zone should be allocated.
     /// @retval true                New Zone with the given index should be allocated.
     /// @retval false               No need to allocate a new zone.
     bool shouldAllocateZone(std::size_t idx);
 
+    /// Checks if zones with the given chunk size should store their headers at the beginning of their own page.
+    /// @param chunkSize            Size of the chunks in the zone.
+    /// @return Flag indicating if the zone header should be stored on-page.
+    /// @retval true                Zone header should be stored on-page.
+    /// @retval false               Zone header should be allocated from the zone descriptors.
+    /// @note On-page header is used only if it doesn't waste more memory than the off-page zone descriptor.
+    [[nodiscard]] bool useOnPageHeader(std::size_t chunkSize) const;
+
     /// Allocates new Zone with the chunks of given size.
     /// @param chunkSize            Size of the chunks in the allocated zone.
+    /// @param tier                 Tier of the memory, from which the zone page should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the zone page.
+    /// @param pinned               Flag indicating if the zone should be pinned for the reserved allocations.
+    /// @return Result of the allocation.
+    /// @retval Zone*               Pointer to the allocated Zone on success.
+    /// @retval nullptr             Some error occurred.
+    Zone* allocateZone(std::size_t chunkSize, Tier tier, Caps caps, bool pinned = false);
+
+    /// Allocates new Zone, which header is stored at the beginning of its own page.
+    /// @param chunkSize            Size of the chunks in the allocated zone.
+    /// @param tier                 Tier of the memory, from which the zone page should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the zone page.
     /// @return Result of the allocation.
     /// @retval Zone*               Pointer to the allocated Zone on success.
     /// @retval nullptr             Some error occurred.
-    Zone* allocateZone(std::size_t chunkSize);
+    Zone* allocateOnPageZone(std::size_t chunkSize, Tier tier, Caps caps);
+
+    /// Allocates new Zone, which header is allocated from the zone descriptors.
+    /// @param chunkSize            Size of the chunks in the allocated zone.
+    /// @param tier                 Tier of the memory, from which the zone page should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the zone page.
+    /// @return Result of the allocation.
+    /// @retval Zone*               Pointer to the allocated Zone on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Zone descriptors are always placed in fast memory first, because they are scanned on each release.
+    ///       They don't need the demanded capabilities, because they are never accessed by the peripherals.
+    Zone* allocateOffPageZone(std::size_t chunkSize, Tier tier, Caps caps);
 
     /// Initializes given zone.
     /// @param zone                 Zone to be initialized.
     /// @param chunkSize            Size of the chunks in this zone.
+    /// @param offset               Offset of the first chunk in the zone page.
+    /// @param tier                 Tier of the memory, from which the zone page should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the zone page.
     /// @return Result of the initialization.
     /// @retval true                Zone has been initialized.
     /// @retval false               Some error occurred.
-    bool initZone(Zone* zone, std::size_t chunkSize);
+    bool initZone(Zone* zone, std::size_t chunkSize, std::size_t offset, Tier tier, Caps caps);
 
-    /// Clears the given zone.
+    /// Clears the given zone and releases its page.
     /// @param zone                 Zone to be cleared.
     void clearZone(Zone* zone);
 
+    /// Returns the page for the new zone with the given chunk size.
+    /// @param chunkSize            Size of the chunks in the zone.
+    /// @param tier                 Tier of the memory, from which the zone page should be taken first.
+    /// @param caps                 Capabilities demanded from the memory region of the zone page.
+    /// @return Result of the allocation.
+    /// @retval Page*               Page for the zone on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Spare pages are used only for zones with the default tier and without capabilities.
+    Page* allocateZonePage(std::size_t chunkSize, Tier tier, Caps caps);
+
+    /// Releases the page of the zone with the given chunk size, keeping it as a spare page if it is still needed.
+    /// @param chunkSize            Size of the chunks in the zone.
+    /// @param page                 Page to be released.
+    void releaseZonePage(std::size_t chunkSize, Page* page);
+
+    /// Releases the spare pages of the zones with the given index, that exceed the current refill size.
+    /// @param idx                  Index of the zones, which spare pages should be trimmed.
+    void trimSparePages(std::size_t idx);
+
+    /// Returns offset of the first chunk in the next zone with the given chunk size, that is caused by colouring.
+    /// @param chunkSize            Size of the chunks in the zone.
+    /// @return Colour offset of the next zone.
+    /// @note Colour offsets are multiples of the chunk size, so chunks remain aligned to their size.
+    std::size_t nextColourOffset(std::size_t chunkSize);
+
+    /// Returns size of the memory used by the given zone, that can't be used for chunks.
+    /// @param zone                 Zone to be checked.
+    /// @return Size of the memory used for the zone header and colouring.
+    std::size_t zoneOverheadSize(Zone* zone);
+
     /// Adds the given zone to the array of known zones.
     /// @param zone                 Zone to be added.
     void addZone(Zone* zone);
@@ -180,6 +380,12 @@ private:
     /// @param zone                 Zone to be removed.
     void removeZone(Zone* zone);
 
+    /// Returns the list of zones, to which the given zone belongs in its current state.
+    /// @param zone                 Zone to be checked.
+    /// @return Pointer to the head of the list, to which given zone belongs.
+    /// @note Partially used zones are grouped by their occupancy only for the fullest-first policy.
+    Zone** zoneList(Zone* zone);
+
     /// Finds the Zone that given chunk belong to.
     /// @param chunk                Chunk for which zone should be found.
     /// @return Result of the search.
@@ -188,19 +394,60 @@ private:
     Zone* findZone(Chunk* chunk);
 
 private:
-    static constexpr std::size_t m_cMaxZoneIdx = 8; ///< Maximal supported entries in the zone array.
+    /// Maximal supported entries in the zone array.
+    static constexpr std::size_t m_cMaxZoneIdx = allocator::cMaxSizeClassesCount;
+    static constexpr std::size_t m_cOccupancyBucketsCount = 4; ///< Number of lists with partially used zones.
+    static constexpr std::size_t m_cCacheLineSize = 64;        ///< Assumed size of the cache line used in colouring.
+    static constexpr std::size_t m_cMaxColourRatio = 8;        ///< Inverse of the maximal page part used in colouring.
 
 private:
     /// Represents the meta-data of the zone.
     struct ZoneInfo {
-        Zone* head{};                  ///< Head of the zones with the given index.
-        std::size_t freeChunksCount{}; ///< Total number of free chunks in zones with the given index.
+        /// Heads of the partially used zones with the given index, grouped by the number of used chunks.
+        std::array<Zone*, m_cOccupancyBucketsCount> partial{};
+        Zone* full{};                        ///< Head of the fully used zones with the given index.
+        Zone* empty{};                       ///< Head of the unused zones with the given index.
+        Zone* pinned{};                      ///< Head of the pinned zones with free chunks with the given index.
+        Zone* pinnedFull{};                  ///< Head of the fully used pinned zones with the given index.
+        std::size_t zonesCount{};            ///< Number of zones with the given index.
+        std::size_t freeChunksCount{};       ///< Total number of free chunks in zones with the given index.
+        std::size_t reservedMemorySize{};    ///< Total size of memory reserved for zones with the given index.
+        std::size_t chunksCount{};           ///< Total number of chunks in zones with the given index.
+        std::size_t pinnedChunksCount{};     ///< Total number of chunks in pinned zones with the given index.
+        std::size_t pinnedFreeChunksCount{}; ///< Total number of free chunks in pinned zones with the given index.
+        std::size_t reservedChunksCount{};   ///< Number of chunks reserved by the users with the given index.
+        std::size_t peakUsedChunksCount{};   ///< Highest number of used chunks in zones with the given index.
+        std::size_t allocationsCount{};      ///< Number of chunks allocated from zones with the given index.
+        std::size_t releasesCount{};         ///< Number of chunks released to zones with the given index.
+        std::size_t nextColour{};            ///< Colour of the next zone with the given index.
+        Page* sparePages{};                  ///< Head of the pages taken for the future zones with the given index.
+        std::size_t sparePagesCount{};       ///< Number of the spare pages for zones with the given index.
+        std::size_t refillPagesCount{1};     ///< Number of pages to be taken at once for zones with the given index.
+        std::size_t idleReleasesCount{};     ///< Number of zones released since the last zone page was taken.
+
+        /// Returns heads of all lists of zones with the given index.
+        /// @return Array with heads of all lists.
+        [[nodiscard]] std::array<Zone*, m_cOccupancyBucketsCount + 4> heads() const
+        {
+            std::array<Zone*, m_cOccupancyBucketsCount + 4> result{};
+            for (std::size_t i = 0; i < partial.size(); ++i)
+                result.at(i) = partial.at(i);
+
+            result.at(partial.size()) = full;
+            result.at(partial.size() + 1) = empty;
+            result.at(partial.size() + 2) = pinned;
+            result.at(partial.size() + 3) = pinnedFull;
+            return result;
+        }
     };
 
     PageAllocator* m_pageAllocator{};              ///< PageAllocator to be used as the source of the new pages.
     std::size_t m_pageSize{};                      ///< Size of the page on this platform.
     std::size_t m_zoneDescChunkSize{};             ///< Size of the chunks that are used to store zone descriptors.
     std::size_t m_zoneDescIdx{};                   ///< Index of the zones, from which zone descriptors are allocated.
+    ZonePolicy m_policy{};                         ///< Policy of selecting zones for allocation.
+    bool m_colouring{};                            ///< Flag indicating if new zones should be coloured.
+    std::size_t m_maxRefillPagesCount{1};          ///< Maximal number of pages taken at once for new zones.
     Zone m_initialZone{};                          ///< Initial static zone.
     std::array<ZoneInfo, m_cMaxZoneIdx> m_zones{}; ///< Array of all zones known in the ZoneAllocator.
 };
@@ -221,7 +468,7 @@ inline std::size_t chunkSize(std::size_t size)
 /// @return Index of the zone in the array of all known zones.
 inline std::size_t zoneIdx(std::size_t chunkSize)
 {
-    return static_cast<std::size_t>(std::floor(std::log2(chunkSize)) - 4);
+    return static_cast<std::size_t>(std::floor(std::log2(chunkSize / ZoneAllocator::minimalAllocSize())));
 }
 
 } // namespace detail
@@ -30,21 +30,14 @@
 ///
 /////////////////////////////////////////////////////////////////////////////////////
 
-#include "PageAllocator.hpp"
-#include "ZoneAllocator.hpp"
 #include "version.hpp"
 
 #include <allocator/allocator.hpp>
 
-#include <array>
-
 namespace {
 
 // NOLINTNEXTLINE(fuchsia-statically-constructed-objects,cppcoreguidelines-avoid-non-const-global-variables)
-memory::PageAllocator pageAllocator;
-
-// NOLINTNEXTLINE(fuchsia-statically-constructed-objects,cppcoreguidelines-avoid-non-const-global-variables)
-memory::ZoneAllocator zoneAllocator;
+memory::Heap heap;
 
 } // namespace
 
@@ -57,55 +50,102 @@ const char* version()
 
 bool init(Region* regions, std::size_t pageSize)
 {
-    clear();
+    return heap.init(regions, pageSize);
+}
 
-    if (!pageAllocator.init(regions, pageSize))
-        return false;
+bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize)
+{
+    return heap.init(start, end, pageSize);
+}
 
-    return zoneAllocator.init(&pageAllocator, pageSize);
+void clear()
+{
+    heap.destroy();
 }
 
-bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize)
+void setZonePolicy(ZonePolicy policy)
 {
-    std::array<Region, 2> regions = {{{start, end - start}, {0, 0}}};
+    heap.setZonePolicy(policy);
+}
 
-    return init(regions.data(), pageSize);
+void setZoneColouring(bool enabled)
+{
+    heap.setZoneColouring(enabled);
 }
 
-void clear()
+void setZoneGrowth(std::size_t maxPagesCount)
 {
-    pageAllocator.clear();
-    zoneAllocator.clear();
+    heap.setZoneGrowth(maxPagesCount);
 }
 
 void* allocate(std::size_t size)
 {
-    return zoneAllocator.allocate(size);
+    return heap.allocate(size);
+}
+
+void* allocate(std::size_t size, Tier tier)
+{
+    return heap.allocate(size, tier);
+}
+
+void* allocate(std::size_t size, Caps caps, std::size_t boundary)
+{
+    return heap.allocate(size, caps, boundary);
+}
+
+bool reserve(std::size_t size, std::size_t count)
+{
+    return heap.reserve(size, count);
+}
+
+void* allocateReserved(std::size_t size)
+{
+    return heap.allocateReserved(size);
 }
 
 void release(void* ptr)
 {
-    zoneAllocator.release(ptr);
+    heap.release(ptr);
+}
+
+void releaseDeferred(void* ptr)
+{
+    heap.releaseDeferred(ptr);
+}
+
+std::size_t drain(std::size_t budget)
+{
+    return heap.drain(budget);
+}
+
+void* tryReserve(std::size_t size)
+{
+    return heap.tryReserve(size);
+}
+
+std::size_t largestFreeBlock()
+{
+    return heap.largestFreeBlock();
+}
+
+double fragmentationIndex()
+{
+    return heap.fragmentationIndex();
 }
 
 Stats getStats()
 {
-    PageAllocator::Stats pageStats = pageAllocator.getStats();
-    ZoneAllocator::Stats zoneStats = zoneAllocator.getStats();
-
-    Stats stats{};
-    stats.totalMemorySize = pageStats.totalMemorySize;
-    // clang-format off
-    stats.reservedMemorySize = pageStats.totalMemorySize - pageStats.effectiveMemorySize // Lost due to the alignment.
-                               + pageStats.reservedPagesCount * pageStats.pageSize       // Reserved by the PageAllocator.
-                               + zoneStats.reservedMemorySize;                           // Reserved by the ZoneAllocator.
-    stats.userMemorySize = stats.totalMemorySize - stats.reservedMemorySize;
-    stats.allocatedMemorySize = pageStats.userMemorySize - pageStats.freeMemorySize - zoneStats.usedMemorySize // Allocated from PageAllocator by user.
-                                + zoneStats.allocatedMemorySize;                                               // Allocated from ZoneAllocator by user.
-    stats.freeMemorySize = stats.userMemorySize - stats.allocatedMemorySize;
-    // clang-format on
-
-    return stats;
+    return heap.getStats();
+}
+
+ExtendedStats getExtendedStats()
+{
+    return heap.getExtendedStats();
+}
+
+Heap& defaultHeap()
+{
+    return heap;
 }
 
 } // namespace memory::allocator
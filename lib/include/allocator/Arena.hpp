@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+class Heap;
+
+/// Represents the arena of memory blocks, that are released all at once. Memory is bump-allocated from page
+/// aligned blocks reserved from the heap, so allocating a memory block costs only a pointer increment.
+/// @note Arena is not thread-safe. Each thread should use its own arena.
+class Arena {
+public:
+    /// Represents the position in the arena, to which it can be rolled back.
+    struct Mark {
+        void* block;             ///< Block, which was used when the mark was taken.
+        std::uintptr_t position; ///< Position in the block, from which the next memory block was allocated.
+    };
+
+    /// Default constructor.
+    Arena() noexcept = default;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Arena is not meant to be copy-constructed.
+    Arena(const Arena&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Arena is not meant to be move-constructed.
+    Arena(Arena&&) = delete;
+
+    /// Destructor. Releases all blocks of the arena.
+    ~Arena();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Arena is not meant to be copy-assigned.
+    Arena& operator=(const Arena&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Arena is not meant to be move-assigned.
+    Arena& operator=(Arena&&) = delete;
+
+    /// Initializes the arena with the given heap and block size.
+    /// @param heap         Heap, from which blocks of the arena are reserved.
+    /// @param blockSize    Size of the blocks reserved from the heap. Should be a multiple of the page size.
+    /// @return Result of the initialization.
+    /// @retval true        Arena has been initialized.
+    /// @retval false       Some error occurred.
+    /// @note All memory blocks allocated from the arena before this call are released.
+    /// @note Heap is not owned by the arena and must outlive it.
+    [[nodiscard]] bool init(Heap* heap, std::size_t blockSize);
+
+    /// Allocates memory block with the given size and alignment.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block. Has to be a power of 2.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Memory blocks bigger than the block size get their own block.
+    [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+        auto position = (m_position + alignment - 1) & ~(alignment - 1);
+        if (size != 0 && position <= m_end && size <= m_end - position) {
+            m_position = position + size;
+            return reinterpret_cast<void*>(position);
+        }
+
+        return allocateSlow(size, alignment);
+    }
+
+    /// Returns the current position in the arena.
+    /// @return Mark, to which the arena can be rolled back.
+    [[nodiscard]] Mark mark() const { return {m_block, m_position}; }
+
+    /// Releases all memory blocks allocated after the given mark was taken.
+    /// @param mark         Mark returned by mark(). It has to be taken after the last init() or reset() and can't
+    ///                     be newer than any mark already used for rollback.
+    void rollback(const Mark& mark);
+
+    /// Releases all memory blocks allocated from the arena and returns all its blocks to the heap.
+    void reset();
+
+    /// Returns the number of blocks currently reserved from the heap.
+    /// @return Number of blocks used by the arena.
+    [[nodiscard]] std::size_t blocksCount() const;
+
+private:
+    /// Represents the header of the block reserved from the heap.
+    struct BlockHeader {
+        BlockHeader* prev;  ///< Previously reserved block.
+        std::uintptr_t end; ///< Address of the block end.
+    };
+
+    /// Reserves a new block from the heap and allocates the memory block from it.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    void* allocateSlow(std::size_t size, std::size_t alignment);
+
+    /// Releases the newest block of the arena and makes the previous one current.
+    void releaseBlock();
+
+private:
+    Heap* m_heap{};              ///< Heap, from which blocks are reserved.
+    std::size_t m_blockSize{};   ///< Size of the blocks reserved from the heap.
+    BlockHeader* m_block{};      ///< Block, from which memory blocks are currently allocated.
+    std::uintptr_t m_position{}; ///< Position in the current block, from which the next memory block is allocated.
+    std::uintptr_t m_end{};      ///< Address of the current block end.
+};
+
+} // namespace memory
@@ -0,0 +1,298 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Region.hpp"
+#include "Stats.hpp"
+#include "ZonePolicy.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+class Tracer;
+
+/// Represents the lock, that protects a heap against concurrent access.
+/// @note liballocator does not depend on any threading library, so the lock has to be provided by the user.
+class HeapLock {
+public:
+    /// Default constructor.
+    HeapLock() = default;
+
+    /// Copy constructor.
+    HeapLock(const HeapLock&) = default;
+
+    /// Move constructor.
+    HeapLock(HeapLock&&) = default;
+
+    /// Virtual destructor.
+    virtual ~HeapLock() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    HeapLock& operator=(const HeapLock&) = default;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    HeapLock& operator=(HeapLock&&) = default;
+
+    /// Acquires the lock. Blocks until the lock is available.
+    virtual void lock() = 0;
+
+    /// Releases the lock.
+    virtual void unlock() = 0;
+};
+
+/// Represents an independent heap. Each heap manages its own memory regions with its own page and zone allocators,
+/// so allocations from different heaps never share pages or zones.
+class Heap {
+public:
+    /// Default constructor.
+    Heap() noexcept;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Heap is not meant to be copy-constructed.
+    Heap(const Heap&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Heap is not meant to be move-constructed.
+    Heap(Heap&&) = delete;
+
+    /// Destructor.
+    ~Heap();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Heap is not meant to be copy-assigned.
+    Heap& operator=(const Heap&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Heap is not meant to be move-assigned.
+    Heap& operator=(Heap&&) = delete;
+
+    /// Initializes the heap with the given array of memory regions and page size.
+    /// @param regions      Array of memory regions to be used by the heap. Last entry should be zeroed.
+    /// @param pageSize     Size of the page on the current platform.
+    /// @return Result of the initialization.
+    /// @retval true        Heap has been initialized.
+    /// @retval false       Some error occurred.
+    /// @note Lock set with setLock() is preserved.
+    [[nodiscard]] bool init(Region* regions, std::size_t pageSize);
+
+    /// Initializes the heap with the given array of memory boundaries and page size.
+    /// @param start        Start address of a memory region to be used by the heap.
+    /// @param end          End address of a memory region to be used by the heap.
+    /// @param pageSize     Size of the page on the current platform.
+    /// @return Result of the initialization.
+    /// @retval true        Heap has been initialized.
+    /// @retval false       Some error occurred.
+    /// @note This overload is equivalent to the above version of init() with only one memory region entry.
+    [[nodiscard]] bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize);
+
+    /// Releases all memory blocks allocated from this heap at once and detaches the heap from its memory regions.
+    /// @note Memory regions can be reused by the caller after this call. Heap has to be initialized again
+    ///       before the next allocation.
+    void destroy();
+
+    /// Sets the lock, that protects this heap against concurrent access.
+    /// @param lock         Lock to be used or nullptr if the heap is used only from one thread.
+    /// @note Lock is not owned by the heap and must outlive it.
+    void setLock(HeapLock* lock);
+
+    /// Sets the tracer, that records all allocations and releases from this heap.
+    /// @param tracer       Tracer to be used or nullptr to disable tracing.
+    /// @note Tracer is not owned by the heap and must outlive it. It is preserved by init() and destroy().
+    void setTracer(Tracer* tracer);
+
+    /// Sets the policy of selecting zones, from which small memory blocks are allocated.
+    /// @param policy       Policy to be used.
+    /// @note Policy is restored to ZonePolicy::eFirstFit on each call to init() or destroy().
+    void setZonePolicy(ZonePolicy policy);
+
+    /// Enables or disables colouring of the zones, from which small memory blocks are allocated.
+    /// @param enabled      Flag indicating if colouring should be enabled.
+    /// @note Colouring is disabled on each call to init() or destroy().
+    void setZoneColouring(bool enabled);
+
+    /// Sets the maximal number of pages taken at once for the new zones of one size class.
+    /// @param maxPagesCount Maximal number of pages taken at once. Value 1 disables the adaptive growth.
+    /// @note Growth is disabled on each call to init() or destroy().
+    void setZoneGrowth(std::size_t maxPagesCount);
+
+    /// Allocates memory block with the given size.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Small memory blocks are placed in fast memory regions first, while bigger ones are placed in normal ones.
+    [[nodiscard]] void* allocate(std::size_t size);
+
+    /// Allocates memory block with the given size, preferring memory regions of the given tier.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param tier         Tier of the memory regions to be tried first.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note If the given tier is exhausted, then memory is taken from slower tiers first and from faster ones after.
+    /// @note Small memory blocks reuse free chunks of existing zones regardless of their tier, so for them the tier
+    ///       only selects placement of the new zones.
+    [[nodiscard]] void* allocate(std::size_t size, Tier tier);
+
+    /// Allocates memory block with the given size from memory regions with the given capabilities.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param caps         Capabilities demanded from the memory region of the block.
+    /// @param boundary     Address boundary, that the block must not cross or 0 if there is no such limit.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Boundary has to be a power of 2 and can't be smaller than the size of the block rounded up to the page
+    ///       size for big blocks or to the power of 2 for small ones.
+    [[nodiscard]] void* allocate(std::size_t size, Caps caps, std::size_t boundary = 0);
+
+    /// Allocates memory block with the given size from the given size class.
+    /// @param sizeClassIdx Index of the size class of the memory block, as returned by sizeClassIdx().
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note This is equivalent to allocate(std::size_t), but it skips the size class lookup, which callers with
+    ///       constant sizes can do at compile time. Sizes not served from zones fall back to the regular path.
+    [[nodiscard]] void* allocateFromSizeClass(std::size_t sizeClassIdx, std::size_t size);
+
+    /// Returns the index of the size class, from which memory blocks with the given size are allocated.
+    /// @param size         Size of the memory block.
+    /// @return Index of the size class or allocator::cMaxSizeClassesCount if the size is bigger than all of them.
+    /// @note Size classes bigger or equal to the page size are not used by the heap. Such memory blocks are
+    ///       allocated as whole pages instead.
+    static constexpr std::size_t sizeClassIdx(std::size_t size)
+    {
+        std::size_t idx = 0;
+        auto chunkSize = allocator::cMinSizeClassChunkSize;
+        for (; chunkSize < size && idx < allocator::cMaxSizeClassesCount; ++idx)
+            chunkSize <<= 1U;
+
+        return idx;
+    }
+
+    /// Pre-creates and pins zones, so that the given number of memory blocks with the given size can always be
+    /// allocated with allocateReserved().
+    /// @param size         Size of the reserved memory blocks.
+    /// @param count        Number of the reserved memory blocks.
+    /// @return Result of the reservation.
+    /// @retval true        Memory blocks have been reserved.
+    /// @retval false       Some error occurred.
+    /// @note Reservations with the same rounded up size add up. Only blocks smaller than the page can be reserved.
+    [[nodiscard]] bool reserve(std::size_t size, std::size_t count);
+
+    /// Allocates memory block with the given size from the memory reserved with reserve().
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Reserved blocks are taken only from the pinned zones without touching the pages of the heap, so this
+    ///       call can't fail as long as the reservation for the given size is not exceeded.
+    [[nodiscard]] void* allocateReserved(std::size_t size);
+
+    /// Releases the memory block pointed by given pointer.
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    /// @note Pointer has to be allocated from this heap.
+    void release(void* ptr);
+
+    /// Queues the memory block pointed by given pointer for the release done later by drain().
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    /// @note Block is only pushed to a lock-free queue without taking the heap lock, so this function can be called
+    ///       from the latency-sensitive paths. Block is not available for allocations until it is drained.
+    /// @note Blocks queued and not drained are dropped on each call to init() or destroy().
+    void releaseDeferred(void* ptr);
+
+    /// Releases the memory blocks queued by releaseDeferred().
+    /// @param budget       Maximal number of blocks to be released in this call.
+    /// @return Number of released blocks.
+    /// @note Blocks exceeding the budget stay queued for the following calls.
+    std::size_t drain(std::size_t budget);
+
+    /// Reserves a contiguous, page-aligned memory block with the given size, if it is available.
+    /// @param size         Demanded size of the reserved memory block.
+    /// @return Result of the reservation.
+    /// @retval void*       Reserved memory block on success.
+    /// @retval nullptr     There is no contiguous free block big enough.
+    /// @note Size isn't checked against largestFreeBlock() first. Recently released blocks are joined on demand, so
+    ///       reservations bigger than largestFreeBlock() can still succeed.
+    /// @note Reserved block is released with release().
+    [[nodiscard]] void* tryReserve(std::size_t size);
+
+    /// Returns the size of the largest memory block, that can currently be allocated at once.
+    /// @return Size of the largest free contiguous memory block.
+    /// @note Recently released small blocks are counted separately until they are joined with their neighbours, so
+    ///       bigger blocks may still be allocated.
+    std::size_t largestFreeBlock();
+
+    /// Returns the fragmentation index of the free memory.
+    /// @return Value in range [0, 1] computed as 1 - largestFreeBlock() / free memory size.
+    /// @note Value 0 means, that all free memory is contiguous or that there is no free memory.
+    double fragmentationIndex();
+
+    /// Returns the size of the page used by the heap.
+    /// @return Size of the page or 0 if the heap is not initialized.
+    std::size_t pageSize();
+
+    /// Returns the current statistics of the heap.
+    /// @return Heap statistics.
+    allocator::Stats getStats();
+
+    /// Returns the detailed statistics of the heap, split into size classes, memory regions and memory tiers.
+    /// @return Extended heap statistics.
+    allocator::ExtendedStats getExtendedStats();
+
+private:
+    struct Impl;
+
+    /// Returns the internal state of the heap.
+    /// @return Internal state of the heap.
+    Impl* impl();
+
+    /// Size of the storage for the internal state. Internal state is kept in place, so that creating a heap
+    /// never requires dynamic memory.
+    static constexpr std::size_t m_cStorageSize = 432 * sizeof(void*);
+
+    alignas(std::max_align_t) std::array<std::byte, m_cStorageSize> m_storage{}; ///< Storage for the internal state.
+    HeapLock* m_lock{};                                                         ///< Lock protecting this heap.
+    Tracer* m_tracer{};                                                         ///< Tracer of the heap events.
+};
+
+} // namespace memory
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace memory {
+
+class Arena;
+class Heap;
+
+/// Represents the polymorphic memory resource, that allocates memory blocks from the heap.
+/// @note Failed allocations are forwarded to std::pmr::null_memory_resource(), which throws std::bad_alloc or
+///       terminates, if exceptions are disabled. Alignments bigger than the page size are not supported.
+class HeapResource : public std::pmr::memory_resource {
+public:
+    /// Constructor.
+    /// @param heap         Heap, from which memory blocks are allocated.
+    /// @note Heap is not owned by the resource and must outlive it.
+    explicit HeapResource(Heap* heap) noexcept;
+
+    /// Returns the heap used by the resource.
+    /// @return Heap used by the resource.
+    [[nodiscard]] Heap* heap() const;
+
+private:
+    /// Allocates memory block with the given size and alignment.
+    /// @param bytes        Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Allocated memory block.
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    /// Releases the given memory block to the heap.
+    /// @param ptr          Memory block to be released.
+    /// @param bytes        Size of the memory block.
+    /// @param alignment    Alignment of the memory block.
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+    /// Checks if memory allocated from this resource can be released by the other one.
+    /// @param other        Resource to be compared.
+    /// @return Flag indicating if both resources are the same object.
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    Heap* m_heap; ///< Heap, from which memory blocks are allocated.
+};
+
+/// Represents the polymorphic memory resource, that allocates memory blocks from the arena.
+/// @note Memory blocks are not released individually. They are returned together with the arena on its reset() or
+///       rollback(), so containers using this resource must not outlive them.
+/// @note Failed allocations are forwarded to std::pmr::null_memory_resource(), which throws std::bad_alloc or
+///       terminates, if exceptions are disabled.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    /// Constructor.
+    /// @param arena        Arena, from which memory blocks are allocated.
+    /// @note Arena is not owned by the resource and must outlive it.
+    explicit ArenaResource(Arena* arena) noexcept;
+
+    /// Returns the arena used by the resource.
+    /// @return Arena used by the resource.
+    [[nodiscard]] Arena* arena() const;
+
+private:
+    /// Allocates memory block with the given size and alignment.
+    /// @param bytes        Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Allocated memory block.
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    /// Does nothing, because memory blocks are released together with the arena.
+    /// @param ptr          Memory block to be released.
+    /// @param bytes        Size of the memory block.
+    /// @param alignment    Alignment of the memory block.
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+    /// Checks if memory allocated from this resource can be released by the other one.
+    /// @param other        Resource to be compared.
+    /// @return Flag indicating if both resources are the same object.
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    Arena* m_arena; ///< Arena, from which memory blocks are allocated.
+};
+
+} // namespace memory
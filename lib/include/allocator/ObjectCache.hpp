@@ -0,0 +1,219 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Stats.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace memory {
+
+class Heap;
+
+/// Represents the cache of objects with the same size, that stay initialized between uses. Objects are stored in
+/// slabs reserved from the heap. Init hook is called for each object only once, when its slab is created, and fini
+/// hook only when the slab is released, so expensive one-time initialization is not repeated on each allocation.
+/// @note Objects are returned to the cache in the state they were released in, so the user has to restore their
+///       reusable state before releasing them.
+/// @note Slabs are aligned to their power of 2 size, so the slab of a released object is found by masking its
+///       address. Apart from the slab header, each object costs only a 16-bit index of the free items stack.
+/// @note Cache is not thread-safe. It has to be protected by the user, if it is shared between threads.
+class Cache {
+public:
+    /// Type of the function initializing or finalizing an object.
+    using ObjectFunction = void (*)(void* object);
+
+    /// Default constructor.
+    Cache() noexcept = default;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Cache is not meant to be copy-constructed.
+    Cache(const Cache&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Cache is not meant to be move-constructed.
+    Cache(Cache&&) = delete;
+
+    /// Destructor. Releases all slabs of the cache.
+    /// @note If some objects are still allocated, then slabs are not released, so that those objects stay valid.
+    ~Cache();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Cache is not meant to be copy-assigned.
+    Cache& operator=(const Cache&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Cache is not meant to be move-assigned.
+    Cache& operator=(Cache&&) = delete;
+
+    /// Initializes the cache with the given object layout and hooks.
+    /// @param heap         Heap, from which slabs of the cache are reserved.
+    /// @param name         Name of the cache reported in its statistics.
+    /// @param size         Size of the objects.
+    /// @param alignment    Alignment of the objects. Has to be a power of 2 not bigger than the page size.
+    /// @param init         Function called once for each object, when its slab is created, or nullptr.
+    /// @param fini         Function called once for each object, when its slab is released, or nullptr.
+    /// @return Result of the initialization.
+    /// @retval true        Cache has been initialized.
+    /// @retval false       Some error occurred.
+    /// @note Heap and name are not owned by the cache and must outlive it.
+    /// @note Initialization fails, if some objects of the previous initialization are still allocated.
+    /// @note Initialization fails, if a slab with the minimal number of objects wouldn't fit in the heap memory.
+    [[nodiscard]] bool init(Heap* heap,
+                            const char* name,
+                            std::size_t size,
+                            std::size_t alignment,
+                            ObjectFunction init = nullptr,
+                            ObjectFunction fini = nullptr);
+
+    /// Releases all slabs of the cache and clears its internal state.
+    /// @return Result of the clearing.
+    /// @retval true        Cache has been cleared.
+    /// @retval false       Some objects are still allocated, so the cache was left untouched.
+    [[nodiscard]] bool clear();
+
+    /// Allocates an initialized object from the cache.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated object on success.
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] void* allocate();
+
+    /// Returns the given object to the cache without finalizing it.
+    /// @param object       Object to be released.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    /// @note Object has to be allocated from this cache.
+    void release(void* object);
+
+    /// Finalizes the objects of all empty slabs and releases those slabs to the heap.
+    /// @note One empty slab is kept by the cache otherwise, so that allocations on the slab boundary don't
+    ///       repeatedly initialize and finalize the same objects.
+    void trim();
+
+    /// Returns the current statistics of the cache.
+    /// @return Cache statistics.
+    [[nodiscard]] allocator::CacheStats getStats() const;
+
+private:
+    struct Slab;
+
+    /// Reserves a new slab from the heap and initializes all its objects.
+    /// @return Result of the creation.
+    /// @retval Slab*       Created slab on success.
+    /// @retval nullptr     Some error occurred.
+    Slab* createSlab();
+
+    /// Finalizes all objects of the given slab and releases it to the heap.
+    /// @param slab         Slab to be destroyed.
+    void destroySlab(Slab* slab);
+
+    /// Returns the object with the given index in the given slab.
+    /// @param slab         Slab of the object.
+    /// @param idx          Index of the object in the slab.
+    /// @return Pointer to the object.
+    void* object(Slab* slab, std::size_t idx) const;
+
+    /// Returns the list of slabs, to which the given slab belongs in its current state.
+    /// @param slab         Slab to be checked.
+    /// @return Pointer to the head of the list, to which given slab belongs.
+    Slab** slabList(Slab* slab);
+
+private:
+    Heap* m_heap{};                  ///< Heap, from which slabs are reserved.
+    std::size_t m_itemSize{};        ///< Size of one item, that is the object size aligned to its alignment.
+    std::size_t m_firstItemOffset{}; ///< Offset of the first item from the start of the slab.
+    std::size_t m_itemsPerSlab{};    ///< Number of items in one slab.
+    ObjectFunction m_init{};         ///< Function initializing the objects.
+    ObjectFunction m_fini{};         ///< Function finalizing the objects.
+    Slab* m_partialSlabs{};          ///< Head of the slabs with both used and free objects.
+    Slab* m_fullSlabs{};             ///< Head of the slabs without free objects.
+    Slab* m_emptySlabs{};            ///< Head of the slabs without used objects.
+    allocator::CacheStats m_stats{}; ///< Statistics of the cache, including its name and layout.
+};
+
+/// Represents the cache of objects of the given type, that stay constructed between uses.
+/// Objects are default-constructed once, when their slab is created, and destroyed when the slab is released.
+/// @tparam T               Type of the cached objects.
+template <typename T>
+class ObjectCache {
+public:
+    /// Initializes the cache.
+    /// @param heap         Heap, from which slabs of the cache are reserved.
+    /// @param name         Name of the cache reported in its statistics.
+    /// @return Result of the initialization.
+    /// @retval true        Cache has been initialized.
+    /// @retval false       Some error occurred.
+    [[nodiscard]] bool init(Heap* heap, const char* name)
+    {
+        return m_cache.init(heap, name, sizeof(T), alignof(T), construct, destroy);
+    }
+
+    /// Destroys all cached objects and clears the internal state of the cache.
+    /// @return Result of the clearing.
+    /// @retval true        Cache has been cleared.
+    /// @retval false       Some objects are still allocated, so the cache was left untouched.
+    [[nodiscard]] bool clear() { return m_cache.clear(); }
+
+    /// Allocates a constructed object from the cache.
+    /// @return Result of the allocation.
+    /// @retval T*          Allocated object on success.
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] T* allocate() { return static_cast<T*>(m_cache.allocate()); }
+
+    /// Returns the given object to the cache without destroying it.
+    /// @param object       Object to be released.
+    void release(T* object) { m_cache.release(object); }
+
+    /// Destroys the objects of all empty slabs and releases those slabs to the heap.
+    void trim() { m_cache.trim(); }
+
+    /// Returns the current statistics of the cache.
+    /// @return Cache statistics.
+    [[nodiscard]] allocator::CacheStats getStats() const { return m_cache.getStats(); }
+
+private:
+    /// Constructs the object of the cached type in the given memory.
+    /// @param object       Memory of the object.
+    static void construct(void* object) { new (object) T(); }
+
+    /// Destroys the object of the cached type.
+    /// @param object       Object to be destroyed.
+    static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+private:
+    Cache m_cache; ///< Untyped cache of the objects.
+};
+
+} // namespace memory
@@ -37,10 +37,59 @@
 
 namespace memory {
 
+/// Represents the speed tier of the memory. Pages are taken from the requested tier first and overflow to slower
+/// tiers, before faster ones are used.
+enum class Tier {
+    eFast,   ///< Fast memory, e.g. core coupled or internal SRAM. Preferred for zones with small memory blocks.
+    eNormal, ///< Memory of regular speed. This is the default tier of regions and of page allocations.
+    eSlow    ///< Slow memory, e.g. external SDRAM.
+};
+
+/// Number of supported memory tiers.
+constexpr std::size_t cTiersCount = 3;
+
+/// Represents the capabilities of the memory, that can be demanded by allocations. Capabilities can be combined.
+enum class Caps : std::uint32_t {
+    eNone = 0,                 ///< No special capabilities.
+    eDma = (1U << 0U),         ///< Memory is reachable by the DMA controllers.
+    eNonCacheable = (1U << 1U) ///< Memory is not cached, so DMA buffers in it don't require cache maintenance.
+};
+
+/// Combines the given capabilities.
+/// @param lhs          First set of capabilities.
+/// @param rhs          Second set of capabilities.
+/// @return Capabilities present in any of the given sets.
+constexpr Caps operator|(Caps lhs, Caps rhs)
+{
+    return Caps(std::uint32_t(lhs) | std::uint32_t(rhs));
+}
+
+/// Intersects the given capabilities.
+/// @param lhs          First set of capabilities.
+/// @param rhs          Second set of capabilities.
+/// @return Capabilities present in both of the given sets.
+constexpr Caps operator&(Caps lhs, Caps rhs)
+{
+    return Caps(std::uint32_t(lhs) & std::uint32_t(rhs));
+}
+
+/// Checks if the given capabilities contain all the demanded ones.
+/// @param caps         Capabilities to be checked.
+/// @param demanded     Demanded capabilities.
+/// @return Flag indicating if all demanded capabilities are available.
+/// @retval true        All demanded capabilities are available.
+/// @retval false       Some of the demanded capabilities are missing.
+constexpr bool hasCaps(Caps caps, Caps demanded)
+{
+    return ((caps & demanded) == demanded);
+}
+
 /// Represents a continuous block of physical memory.
 struct Region {
-    std::uintptr_t address; ///< Physical address of the memory block.
-    std::size_t size;       ///< Size of the memory block in bytes.
+    std::uintptr_t address;   ///< Physical address of the memory block.
+    std::size_t size;         ///< Size of the memory block in bytes.
+    Tier tier{Tier::eNormal}; ///< Speed tier of the memory block.
+    Caps caps{Caps::eNone};   ///< Capabilities of the memory block.
 };
 
 } // namespace memory
@@ -0,0 +1,119 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Region.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory::allocator {
+
+/// Maximal number of size classes, that are reported in the extended statistics.
+constexpr std::size_t cMaxSizeClassesCount = 9;
+
+/// Size of the chunks in the smallest size class. Each next size class doubles it.
+constexpr std::size_t cMinSizeClassChunkSize = 8;
+
+/// Maximal number of memory regions, that are reported in the extended statistics.
+constexpr std::size_t cMaxRegionsCount = 8;
+
+/// Represents the statistical data of the allocator.
+struct Stats {
+    std::size_t totalMemorySize;     ///< Total size of the memory passed during initialization.
+    std::size_t reservedMemorySize;  ///< Size of the memory reserved for the liballocator or ignored due to alignment.
+    std::size_t userMemorySize;      ///< Size of the memory available to the user.
+    std::size_t allocatedMemorySize; ///< Size of the memory allocated by the user.
+    std::size_t freeMemorySize;      ///< Size of the free user memory.
+};
+
+/// Represents the statistical data of one size class of small memory blocks.
+/// @note Chunks used internally for zone descriptors are counted in the size class, from which they are allocated.
+struct SizeClassStats {
+    std::size_t chunkSize;           ///< Size of the chunks in this size class.
+    std::size_t zonesCount;          ///< Current number of zones in this size class.
+    std::size_t liveChunksCount;     ///< Current number of allocated chunks.
+    std::size_t peakChunksCount;     ///< Highest number of allocated chunks since initialization.
+    std::size_t allocationsCount;    ///< Total number of chunk allocations since initialization.
+    std::size_t releasesCount;       ///< Total number of chunk releases since initialization.
+    std::size_t wastedMemorySize;    ///< Zone memory not allocated by the user (headers, slack, free chunks, spares).
+    std::size_t reservedChunksCount; ///< Number of chunks reserved for the reserved allocations.
+    std::size_t pinnedChunksCount;   ///< Number of chunks in zones pinned for the reserved allocations.
+    std::size_t sparePagesCount;     ///< Number of pages taken in advance for the future zones.
+};
+
+/// Represents the statistical data of one memory region.
+struct RegionStats {
+    std::uintptr_t start;             ///< Aligned physical address of the region start.
+    Tier tier;                        ///< Speed tier of the region.
+    Caps caps;                        ///< Capabilities of the region.
+    std::size_t pagesCount;           ///< Number of pages in this region.
+    std::size_t freePagesCount;       ///< Current number of free pages in this region.
+    std::size_t peakUsedPagesCount;   ///< Highest number of used pages in this region since initialization.
+    std::size_t largestFreeGroupSize; ///< Number of pages in the largest group of free pages in this region.
+};
+
+/// Represents the statistical data of all memory regions with the same speed tier.
+struct TierStats {
+    std::size_t pagesCount;       ///< Number of pages in regions of this tier.
+    std::size_t freePagesCount;   ///< Current number of free pages in regions of this tier.
+    std::size_t requestsCount;    ///< Total number of page allocations requested from this tier since initialization.
+    std::size_t fallbacksCount;   ///< Number of requested page allocations, that were served from another tier.
+    std::size_t servedPagesCount; ///< Total number of pages allocated from this tier since initialization.
+};
+
+/// Represents the statistical data of one object cache.
+struct CacheStats {
+    const char* name;             ///< Name of the cache.
+    std::size_t objectSize;       ///< Size of the cached objects.
+    std::size_t slabSize;         ///< Size of one slab of the cache.
+    std::size_t slabsCount;       ///< Current number of slabs in the cache.
+    std::size_t objectsCount;     ///< Current number of initialized objects in all slabs.
+    std::size_t liveObjectsCount; ///< Current number of allocated objects.
+    std::size_t peakObjectsCount; ///< Highest number of allocated objects since initialization.
+    std::size_t allocationsCount; ///< Total number of object allocations since initialization.
+    std::size_t releasesCount;    ///< Total number of object releases since initialization.
+    std::size_t initsCount;       ///< Total number of object initializations since initialization.
+};
+
+/// Represents the detailed statistical data of the allocator.
+struct ExtendedStats {
+    std::array<SizeClassStats, cMaxSizeClassesCount> sizeClasses; ///< Statistics of the size classes.
+    std::size_t sizeClassesCount;                                  ///< Number of valid entries in sizeClasses.
+    std::array<RegionStats, cMaxRegionsCount> regions;             ///< Statistics of the memory regions.
+    std::size_t regionsCount;                                      ///< Number of valid entries in regions.
+    std::array<TierStats, cTiersCount> tiers;                      ///< Statistics of the tiers, indexed by Tier.
+};
+
+} // namespace memory::allocator
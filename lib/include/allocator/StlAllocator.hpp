@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Arena.hpp"
+#include "Heap.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace memory {
+namespace detail {
+
+/// Handles the allocation, that failed in the allocator of the standard containers.
+/// @param size         Demanded size of the memory block.
+/// @param alignment    Demanded alignment of the memory block.
+/// @note Containers use the returned memory without checking it, so the failure is delegated to
+///       std::pmr::null_memory_resource(), which throws std::bad_alloc or terminates the program, depending on
+///       the exceptions support.
+[[noreturn]] void allocationFailed(std::size_t size, std::size_t alignment);
+
+} // namespace detail
+
+/// Represents the allocator compatible with the standard containers, that allocates objects from the given heap or
+/// arena. Each container can be bound to its own memory source without overriding the global operator new.
+/// @tparam T               Type of the allocated objects.
+/// @tparam Source          Type of the memory source. It has to be either Heap or Arena.
+/// @note Failed allocations never return nullptr. They throw std::bad_alloc, if exceptions are enabled, or
+///       terminate the program otherwise.
+/// @note Objects allocated from the arena are not released individually. They are returned together with the arena
+///       on its reset() or rollback(), so containers using it must not outlive them.
+template <typename T, typename Source = Heap>
+class StlAllocator {
+    static_assert(std::is_same_v<Source, Heap> || std::is_same_v<Source, Arena>, "unsupported memory source");
+
+public:
+    using value_type = T; ///< Type of the allocated objects.
+
+    /// Constructor.
+    /// @param source       Memory source, from which objects are allocated.
+    /// @note Memory source is not owned by the allocator and must outlive it.
+    explicit StlAllocator(Source* source) noexcept
+        : m_source(source)
+    {
+    }
+
+    /// Converting constructor used by the containers to allocate their internal nodes.
+    /// @param other        Allocator of the other type to be converted.
+    template <typename U>
+    StlAllocator(const StlAllocator<U, Source>& other) noexcept // NOLINT(google-explicit-constructor)
+        : m_source(other.source())
+    {
+    }
+
+    /// Allocates memory for the given number of objects.
+    /// @param count        Number of the objects.
+    /// @return Allocated memory.
+    /// @note If the allocation fails, then detail::allocationFailed() is called, so this never returns nullptr.
+    [[nodiscard]] T* allocate(std::size_t count)
+    {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            detail::allocationFailed(std::numeric_limits<std::size_t>::max(), alignof(T));
+
+        void* ptr{};
+        if constexpr (std::is_same_v<Source, Arena>) {
+            ptr = m_source->allocate(count * sizeof(T), alignof(T));
+        }
+        else if (count == 1) {
+            // Node based containers allocate objects one by one, so their size class is known at compile time.
+            constexpr auto cSizeClassIdx = Heap::sizeClassIdx(sizeof(T));
+            ptr = m_source->allocateFromSizeClass(cSizeClassIdx, sizeof(T));
+        }
+        else {
+            ptr = m_source->allocate(count * sizeof(T));
+        }
+
+        if (ptr == nullptr)
+            detail::allocationFailed(count * sizeof(T), alignof(T));
+
+        return static_cast<T*>(ptr);
+    }
+
+    /// Releases memory of the given objects.
+    /// @param ptr          Memory to be released.
+    /// @param count        Number of the objects.
+    void deallocate(T* ptr, [[maybe_unused]] std::size_t count) noexcept
+    {
+        if constexpr (std::is_same_v<Source, Heap>)
+            m_source->release(ptr);
+    }
+
+    /// Returns the memory source used by the allocator.
+    /// @return Memory source used by the allocator.
+    [[nodiscard]] Source* source() const noexcept { return m_source; }
+
+private:
+    Source* m_source; ///< Memory source, from which objects are allocated.
+};
+
+/// Checks if memory allocated by one allocator can be released by the other one.
+/// @tparam T               Type of the objects allocated by the first allocator.
+/// @tparam U               Type of the objects allocated by the second allocator.
+/// @tparam Source          Type of the memory source.
+/// @param lhs              First allocator to be compared.
+/// @param rhs              Second allocator to be compared.
+/// @return Flag indicating if both allocators use the same memory source.
+template <typename T, typename U, typename Source>
+bool operator==(const StlAllocator<T, Source>& lhs, const StlAllocator<U, Source>& rhs) noexcept
+{
+    return (lhs.source() == rhs.source());
+}
+
+/// Checks if memory allocated by one allocator can't be released by the other one.
+/// @tparam T               Type of the objects allocated by the first allocator.
+/// @tparam U               Type of the objects allocated by the second allocator.
+/// @tparam Source          Type of the memory source.
+/// @param lhs              First allocator to be compared.
+/// @param rhs              Second allocator to be compared.
+/// @return Flag indicating if allocators use different memory sources.
+template <typename T, typename U, typename Source>
+bool operator!=(const StlAllocator<T, Source>& lhs, const StlAllocator<U, Source>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+} // namespace memory
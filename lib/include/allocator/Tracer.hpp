@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+/// Represents the type of the traced allocation event.
+enum class TraceEventType : std::uint8_t {
+    eAllocate = 1, ///< Memory block has been allocated.
+    eRelease = 2   ///< Memory block has been released.
+};
+
+/// Represents one traced allocation event. Each event has the fixed size of 24 bytes.
+struct TraceEvent {
+    std::uint64_t timestamp; ///< Value returned by the trace clock or 0 if no clock was given.
+    std::uint64_t address;   ///< Address of the allocated or released memory block.
+    std::uint32_t size;      ///< Demanded size of the allocated block saturated to UINT32_MAX or 0 for releases.
+    std::uint16_t threadId;  ///< Value returned by the thread id function or 0 if no function was given.
+    TraceEventType type;     ///< Type of the event.
+    std::uint8_t reserved;   ///< Reserved for future use. Always 0.
+};
+
+static_assert(sizeof(TraceEvent) == 24, "TraceEvent is expected to have the fixed size");
+
+/// Represents the slot of the tracer ring buffer, that stores one event.
+/// @note Sequence works like a per-slot seqlock. It is odd while the event is being written and even afterwards,
+///       when it identifies the recorded event, so the export can detect events, that are torn or overwritten.
+struct TraceSlot {
+    std::atomic<std::size_t> sequence{}; ///< Sequence number of the event stored in this slot.
+    TraceEvent event{};                  ///< Event stored in this slot.
+};
+
+/// Represents the header of the exported binary trace.
+/// @note Binary trace consists of this header followed by eventsCount TraceEvent records, ordered from the oldest
+///       to the newest one. All fields are stored in the native byte order of the traced platform. Readers can
+///       detect the byte order from the eventSize field, which is always 24.
+struct TraceHeader {
+    std::array<char, 4> magic;  ///< Magic value "LATR".
+    std::uint16_t version;      ///< Version of the trace format. Currently 1.
+    std::uint16_t eventSize;    ///< Size of one event record in bytes.
+    std::uint64_t eventsCount;  ///< Number of event records following this header.
+    std::uint64_t droppedCount; ///< Number of the oldest events, that were overwritten before the export.
+    std::uint64_t reserved;     ///< Reserved for future use. Always 0.
+};
+
+static_assert(sizeof(TraceHeader) == 32, "TraceHeader is expected to have the fixed size");
+
+/// Represents the ring buffer of allocation events. Recording is lock-free, so one tracer can be shared by many
+/// heaps and threads. When the buffer is full, the oldest events are overwritten.
+/// @note Each event claims its own slot. If the buffer wraps around while an older event is still being written to
+///       the same slot, then the newer event is dropped instead of being mixed with the older one.
+class Tracer {
+public:
+    /// Type of the function returning the current timestamp.
+    using ClockFunction = std::uint64_t (*)();
+
+    /// Type of the function returning the identifier of the current thread.
+    using ThreadIdFunction = std::uint16_t (*)();
+
+    /// Default constructor.
+    Tracer() noexcept = default;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Tracer is not meant to be copy-constructed.
+    Tracer(const Tracer&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Tracer is not meant to be move-constructed.
+    Tracer(Tracer&&) = delete;
+
+    /// Destructor.
+    ~Tracer() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Tracer is not meant to be copy-assigned.
+    Tracer& operator=(const Tracer&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Tracer is not meant to be move-assigned.
+    Tracer& operator=(Tracer&&) = delete;
+
+    /// Initializes the tracer with the given storage for events.
+    /// @param slots        Storage for the events.
+    /// @param capacity     Number of slots in the storage. Has to be a power of 2.
+    /// @param clock        Function returning the current timestamp or nullptr.
+    /// @param threadId     Function returning the identifier of the current thread or nullptr.
+    /// @return Result of the initialization.
+    /// @retval true        Tracer has been initialized.
+    /// @retval false       Some error occurred.
+    [[nodiscard]] bool init(TraceSlot* slots,
+                            std::size_t capacity,
+                            ClockFunction clock = nullptr,
+                            ThreadIdFunction threadId = nullptr);
+
+    /// Clears the internal state of the tracer.
+    void clear();
+
+    /// Records the given event.
+    /// @param type         Type of the event.
+    /// @param ptr          Address of the memory block.
+    /// @param size         Demanded size of the memory block.
+    /// @note Sizes, that don't fit in TraceEvent::size, are saturated to UINT32_MAX.
+    void record(TraceEventType type, const void* ptr, std::size_t size);
+
+    /// Returns the total number of events recorded since initialization, including the overwritten ones.
+    /// @return Number of recorded events.
+    [[nodiscard]] std::size_t recordedCount() const;
+
+    /// Returns the size of the binary trace, that would be exported now.
+    /// @return Size of the binary trace in bytes.
+    /// @note This is the upper bound, because events torn by the concurrent writers are skipped by the export.
+    [[nodiscard]] std::size_t exportSize() const;
+
+    /// Exports the recorded events in the binary trace format described by TraceHeader.
+    /// @param buffer       Buffer for the binary trace. It can be for example a memory-mapped file.
+    /// @param size         Size of the given buffer.
+    /// @return Number of bytes written to the buffer or 0 if the buffer is too small.
+    /// @note Events, that are being written or overwritten during the export, are skipped and counted as dropped.
+    std::size_t exportTrace(void* buffer, std::size_t size) const;
+
+private:
+    TraceSlot* m_slots{};                  ///< Storage for the events.
+    std::size_t m_capacity{};              ///< Number of slots in the storage.
+    ClockFunction m_clock{};               ///< Function returning the current timestamp.
+    ThreadIdFunction m_threadId{};         ///< Function returning the identifier of the current thread.
+    std::atomic<std::size_t> m_recorded{}; ///< Total number of recorded events.
+};
+
+} // namespace memory
@@ -32,22 +32,16 @@
 
 #pragma once
 
+#include "Heap.hpp"
 #include "Region.hpp"
+#include "Stats.hpp"
+#include "ZonePolicy.hpp"
 
 #include <cstddef>
 #include <cstdint>
 
 namespace memory::allocator {
 
-/// Represents the statistical data of the allocator.
-struct Stats {
-    std::size_t totalMemorySize;     ///< Total size of the memory passed during initialization.
-    std::size_t reservedMemorySize;  ///< Size of the memory reserved for the liballocator or ignored due to alignment.
-    std::size_t userMemorySize;      ///< Size of the memory available to the user.
-    std::size_t allocatedMemorySize; ///< Size of the memory allocated by the user.
-    std::size_t freeMemorySize;      ///< Size of the free user memory.
-};
-
 /// Returns version of liballocator.
 /// @return Version of liballocator.
 const char* version();
@@ -73,6 +67,24 @@ const char* version();
 /// Clears the internal state of liballocator.
 void clear();
 
+/// Sets the policy of selecting zones, from which small memory blocks are allocated.
+/// @param policy       Policy to be used.
+/// @note Policy is restored to ZonePolicy::eFirstFit on each call to init() or clear().
+void setZonePolicy(ZonePolicy policy);
+
+/// Enables or disables colouring of the zones, from which small memory blocks are allocated.
+/// @param enabled      Flag indicating if colouring should be enabled.
+/// @note Colouring spreads the first chunks of zones across different cache sets at the cost of up to 1/8 of
+///       each zone page. It is disabled on each call to init() or clear().
+void setZoneColouring(bool enabled);
+
+/// Sets the maximal number of pages taken at once for the new zones of one size class.
+/// @param maxPagesCount Maximal number of pages taken at once. Value 1 disables the adaptive growth.
+/// @note Size classes, that run out of chunks repeatedly, double their batch up to the given limit and keep the
+///       unused pages for later zones. Idle size classes shrink their batch again. Growth is disabled on each call
+///       to init() or clear().
+void setZoneGrowth(std::size_t maxPagesCount);
+
 /// Allocates memory block with the given size.
 /// @param size         Demanded size of the allocated memory block.
 /// @return Result of the allocation.
@@ -80,13 +92,92 @@ void clear();
 /// @retval nullptr     Some error occurred.
 [[nodiscard]] void* allocate(std::size_t size);
 
+/// Allocates memory block with the given size, preferring memory regions of the given tier.
+/// @param size         Demanded size of the allocated memory block.
+/// @param tier         Tier of the memory regions to be tried first.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note If the given tier is exhausted, then memory is taken from slower tiers first and from faster ones after.
+[[nodiscard]] void* allocate(std::size_t size, Tier tier);
+
+/// Allocates memory block with the given size from memory regions with the given capabilities.
+/// @param size         Demanded size of the allocated memory block.
+/// @param caps         Capabilities demanded from the memory region of the block.
+/// @param boundary     Address boundary, that the block must not cross or 0 if there is no such limit.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note Boundary has to be a power of 2 and can't be smaller than the size of the block rounded up to the page
+///       size for big blocks or to the power of 2 for small ones.
+[[nodiscard]] void* allocate(std::size_t size, Caps caps, std::size_t boundary = 0);
+
+/// Pre-creates and pins zones, so that the given number of memory blocks with the given size can always be
+/// allocated with allocateReserved().
+/// @param size         Size of the reserved memory blocks.
+/// @param count        Number of the reserved memory blocks.
+/// @return Result of the reservation.
+/// @retval true        Memory blocks have been reserved.
+/// @retval false       Some error occurred.
+/// @note Reservations with the same rounded up size add up. Only blocks smaller than the page can be reserved.
+[[nodiscard]] bool reserve(std::size_t size, std::size_t count);
+
+/// Allocates memory block with the given size from the memory reserved with reserve().
+/// @param size         Demanded size of the allocated memory block.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note Reserved blocks are taken only from the pinned zones without touching the pages of the heap, so this
+///       call can't fail as long as the reservation for the given size is not exceeded.
+[[nodiscard]] void* allocateReserved(std::size_t size);
+
 /// Releases the memory block pointed by given pointer.
 /// @param ptr          Pointer to the memory block, that should be released.
 /// @note If the given pointer is nullptr, then function exists without an error.
 void release(void* ptr);
 
+/// Queues the memory block pointed by given pointer for the release done later by drain().
+/// @param ptr          Pointer to the memory block, that should be released.
+/// @note Queueing takes a single lock-free push, so it is suitable for interrupt handlers and other
+///       latency-sensitive paths. Zone and page bookkeeping is done by drain(), e.g. from an idle task.
+void releaseDeferred(void* ptr);
+
+/// Releases the memory blocks queued by releaseDeferred().
+/// @param budget       Maximal number of blocks to be released in this call.
+/// @return Number of released blocks.
+std::size_t drain(std::size_t budget);
+
+/// Reserves a contiguous, page-aligned memory block with the given size, if it is available.
+/// @param size         Demanded size of the reserved memory block.
+/// @return Result of the reservation.
+/// @retval void*       Reserved memory block on success.
+/// @retval nullptr     There is no contiguous free block big enough.
+/// @note Size isn't checked against largestFreeBlock() first. Recently released blocks are joined on demand, so
+///       reservations bigger than largestFreeBlock() can still succeed.
+/// @note Reserved block is released with release().
+[[nodiscard]] void* tryReserve(std::size_t size);
+
+/// Returns the size of the largest memory block, that can currently be allocated at once.
+/// @return Size of the largest free contiguous memory block.
+/// @note Recently released small blocks are counted separately until they are joined with their neighbours, so
+///       bigger blocks may still be allocated.
+std::size_t largestFreeBlock();
+
+/// Returns the fragmentation index of the free memory.
+/// @return Value in range [0, 1] computed as 1 - largestFreeBlock() / free memory size.
+double fragmentationIndex();
+
 /// Returns the current statistics of the allocator.
 /// @return liballocator statistics.
 Stats getStats();
 
+/// Returns the detailed statistics of the allocator, split into size classes, memory regions and memory tiers.
+/// @return Extended liballocator statistics.
+ExtendedStats getExtendedStats();
+
+/// Returns the default heap, that is used by all the above functions.
+/// @return Default heap.
+/// @note Default heap can be used to set the lock protecting the free functions against concurrent access.
+Heap& defaultHeap();
+
 } // namespace memory::allocator
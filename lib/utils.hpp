@@ -64,6 +64,15 @@ inline std::size_t roundPowerOf2(std::size_t value)
     return result;
 }
 
+/// Returns the given value, that is rounded up to the closest multiple of the given alignment.
+/// @param value        Value to be rounded.
+/// @param alignment    Alignment to be used. It must be a power of 2.
+/// @return Value rounded up to the closest multiple of the alignment.
+inline std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
 /// Returns the given pointer moved by given number of bytes.
 /// @param ptr          Pointer to be moved.
 /// @param step         Number of bytes to move the pointer.
@@ -0,0 +1,236 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "PerfCounters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace bench {
+namespace {
+
+/// Returns the perf_event_open() type and config of the given event.
+std::pair<std::uint32_t, std::uint64_t> eventConfig(PerfEvent event)
+{
+    constexpr int cCacheIdShift = 0;
+    constexpr int cCacheOpShift = 8;
+    constexpr int cCacheResultShift = 16;
+
+    switch (event) {
+        case PerfEvent::eCycles: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case PerfEvent::eInstructions: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case PerfEvent::eL1dMisses:
+            return {PERF_TYPE_HW_CACHE,
+                    (PERF_COUNT_HW_CACHE_L1D << cCacheIdShift) | (PERF_COUNT_HW_CACHE_OP_READ << cCacheOpShift)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << cCacheResultShift)};
+        case PerfEvent::eLlcMisses: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+        case PerfEvent::eBranchMisses: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+    }
+
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+}
+
+/// Opens the counter of the given event for the calling thread and its future child threads.
+/// @return File descriptor of the counter or -1 if it is not available.
+int openCounter(PerfEvent event)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    std::tie(attr.type, attr.config) = eventConfig(event);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0)); // NOLINT
+}
+
+} // namespace
+
+const char* toString(PerfEvent event)
+{
+    switch (event) {
+        case PerfEvent::eCycles: return "cycles";
+        case PerfEvent::eInstructions: return "instructions";
+        case PerfEvent::eL1dMisses: return "l1dMisses";
+        case PerfEvent::eLlcMisses: return "llcMisses";
+        case PerfEvent::eBranchMisses: return "branchMisses";
+    }
+
+    return "unknown";
+}
+
+PerfValues unavailablePerfValues()
+{
+    PerfValues values{};
+    values.fill(-1.0);
+    return values;
+}
+
+PerfValues perOperation(const PerfValues& values, std::size_t opsCount)
+{
+    auto result = values;
+    for (auto& value : result) {
+        if (value >= 0.0)
+            value = (opsCount != 0) ? value / double(opsCount) : 0.0;
+    }
+
+    return result;
+}
+
+bool isAvailable(const PerfValues& values)
+{
+    for (auto value : values) {
+        if (value >= 0.0)
+            return true;
+    }
+
+    return false;
+}
+
+PerfCounters::PerfCounters()
+{
+    m_fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (auto fd : m_fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+bool PerfCounters::init()
+{
+    bool available = false;
+    for (std::size_t i = 0; i < m_fds.size(); ++i) {
+        if (m_fds[i] < 0)
+            m_fds[i] = openCounter(PerfEvent(i));
+
+        available |= (m_fds[i] >= 0);
+    }
+
+    return available;
+}
+
+void PerfCounters::start()
+{
+    for (auto fd : m_fds) {
+        if (fd < 0)
+            continue;
+
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);  // NOLINT
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); // NOLINT
+    }
+}
+
+PerfValues PerfCounters::stop()
+{
+    for (auto fd : m_fds) {
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); // NOLINT
+    }
+
+    auto values = unavailablePerfValues();
+    for (std::size_t i = 0; i < m_fds.size(); ++i) {
+        // Layout of the data is given by the read_format: value, time enabled and time running.
+        std::array<std::uint64_t, 3> data{};
+        if (m_fds[i] < 0 || read(m_fds[i], data.data(), sizeof(data)) != sizeof(data))
+            continue;
+
+        auto [value, enabled, running] = data;
+        if (running == 0)
+            continue;
+
+        values.at(i) = double(value) * double(enabled) / double(running);
+    }
+
+    return values;
+}
+
+void printPerfSeparator()
+{
+    for (std::size_t i = 0; i < cPerfEventsCount; ++i)
+        std::printf("---------+"); // NOLINT
+}
+
+void printPerfHeader()
+{
+    std::printf("  cycles |  instrs |  L1d mi |  LLC mi |  br mis |"); // NOLINT
+}
+
+void printPerfValues(const PerfValues& values)
+{
+    for (auto value : values) {
+        if (value < 0.0)
+            std::printf(" %7s |", "n/a"); // NOLINT
+        else
+            std::printf(" %7.1f |", value); // NOLINT
+    }
+}
+
+void writePerfJson(std::FILE* file, const PerfValues& values)
+{
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (values[i] < 0.0)
+            std::fprintf(file, ", \"%s\": null", toString(PerfEvent(i))); // NOLINT
+        else
+            std::fprintf(file, ", \"%s\": %.3f", toString(PerfEvent(i)), values[i]); // NOLINT
+    }
+}
+
+void writePerfCsvHeader(std::FILE* file)
+{
+    for (std::size_t i = 0; i < cPerfEventsCount; ++i)
+        std::fprintf(file, ",%s", toString(PerfEvent(i))); // NOLINT
+}
+
+void writePerfCsv(std::FILE* file, const PerfValues& values)
+{
+    for (auto value : values) {
+        if (value < 0.0)
+            std::fprintf(file, ","); // NOLINT
+        else
+            std::fprintf(file, ",%.3f", value); // NOLINT
+    }
+}
+
+} // namespace bench
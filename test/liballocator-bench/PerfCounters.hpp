@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench {
+
+/// Represents the hardware event counted by PerfCounters.
+enum class PerfEvent {
+    eCycles,       ///< CPU cycles.
+    eInstructions, ///< Retired instructions.
+    eL1dMisses,    ///< L1 data cache read misses.
+    eLlcMisses,    ///< Last level cache misses.
+    eBranchMisses  ///< Mispredicted branches.
+};
+
+/// Number of events counted by PerfCounters.
+constexpr std::size_t cPerfEventsCount = 5;
+
+/// Values of all counted events indexed by PerfEvent. Negative value marks the counter, that is not available.
+using PerfValues = std::array<double, cPerfEventsCount>;
+
+/// Returns the short name of the given event.
+/// @param event        Event to be converted.
+/// @return Name of the event.
+const char* toString(PerfEvent event);
+
+/// Returns the values marking all counters as not available.
+/// @return Values with all counters not available.
+PerfValues unavailablePerfValues();
+
+/// Returns the given values divided by the number of operations.
+/// @param values       Values to be divided.
+/// @param opsCount     Number of operations.
+/// @return Values per operation. Counters, that are not available, stay marked as such.
+PerfValues perOperation(const PerfValues& values, std::size_t opsCount);
+
+/// Checks if at least one of the given counters is available.
+/// @param values       Values to be checked.
+/// @return Flag indicating if at least one counter is available.
+bool isAvailable(const PerfValues& values);
+
+/// Reads hardware performance counters of the calling thread and all threads created by it later on.
+/// @note Counters are read with Linux perf_event_open(). Each counter is opened separately, so counters, that are
+///       not supported by the CPU or not permitted by perf_event_paranoid, are just reported as not available.
+///       Counters multiplexed by the kernel are scaled by the ratio of their enabled and running time.
+class PerfCounters {
+public:
+    /// Default constructor.
+    PerfCounters();
+
+    /// Copy constructor.
+    PerfCounters(const PerfCounters&) = delete;
+
+    /// Move constructor.
+    PerfCounters(PerfCounters&&) = delete;
+
+    /// Destructor.
+    ~PerfCounters();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    PerfCounters& operator=(PerfCounters&&) = delete;
+
+    /// Opens the counters.
+    /// @return Flag indicating if at least one counter could be opened.
+    /// @retval true        At least one counter is available.
+    /// @retval false       No counter is available.
+    bool init();
+
+    /// Resets and starts all available counters.
+    void start();
+
+    /// Stops all available counters and returns their values.
+    /// @return Values counted since the last start().
+    PerfValues stop();
+
+private:
+    std::array<int, cPerfEventsCount> m_fds;
+};
+
+/// Prints the table separator segment covering the counter cells.
+void printPerfSeparator();
+
+/// Prints header cells for the counters per operation, each followed by a column separator.
+void printPerfHeader();
+
+/// Prints cells with the given values, each followed by a column separator.
+/// @param values       Values to be printed.
+void printPerfValues(const PerfValues& values);
+
+/// Writes the given values as JSON object members, each preceded by a comma. Values not available are null.
+/// @param file         File to write the values to.
+/// @param values       Values to be written.
+void writePerfJson(std::FILE* file, const PerfValues& values);
+
+/// Writes the names of the counters as CSV header columns, each preceded by a comma.
+/// @param file         File to write the names to.
+void writePerfCsvHeader(std::FILE* file);
+
+/// Writes the given values as CSV columns, each preceded by a comma. Values not available are empty.
+/// @param file         File to write the values to.
+/// @param values       Values to be written.
+void writePerfCsv(std::FILE* file, const PerfValues& values);
+
+} // namespace bench
@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Targets.hpp"
+
+#include <malloc.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace bench {
+namespace {
+
+/// Returns the number of bytes currently taken from the system by glibc malloc.
+std::size_t mallocFootprint()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    auto info = mallinfo2();
+    return info.arena + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/// Heap lock using std::mutex.
+class MutexLock : public memory::HeapLock {
+public:
+    void lock() override { m_mutex.lock(); }
+    void unlock() override { m_mutex.unlock(); }
+
+private:
+    std::mutex m_mutex;
+};
+
+/// Target using liballocator heap.
+class LiballocatorTarget : public Target {
+public:
+    LiballocatorTarget(std::size_t pageSize, std::size_t memorySize)
+        : m_pageSize(pageSize)
+        , m_memorySize(memorySize)
+        , m_memory(static_cast<std::byte*>(std::aligned_alloc(pageSize, memorySize)), &std::free)
+    {}
+
+    bool init(bool threadSafe)
+    {
+        if (!m_memory)
+            return false;
+
+        if (threadSafe)
+            m_heap.setLock(&m_lock);
+
+        auto start = std::uintptr_t(m_memory.get());
+        return m_heap.init(start, start + m_memorySize, m_pageSize);
+    }
+
+    [[nodiscard]] const char* name() const override { return "liballocator"; }
+    void* allocate(std::size_t size) override { return m_heap.allocate(size); }
+    void release(void* ptr, std::size_t /*size*/) override { m_heap.release(ptr); }
+    double fragmentationIndex() override { return m_heap.fragmentationIndex(); }
+
+    std::size_t footprint() override
+    {
+        auto stats = m_heap.getExtendedStats();
+
+        std::size_t usedPagesCount = 0;
+        for (std::size_t i = 0; i < stats.regionsCount; ++i)
+            usedPagesCount += stats.regions.at(i).pagesCount - stats.regions.at(i).freePagesCount;
+
+        return usedPagesCount * m_pageSize;
+    }
+
+    std::size_t peakFootprint() override
+    {
+        auto stats = m_heap.getExtendedStats();
+
+        std::size_t peakUsedPagesCount = 0;
+        for (std::size_t i = 0; i < stats.regionsCount; ++i)
+            peakUsedPagesCount += stats.regions.at(i).peakUsedPagesCount;
+
+        return peakUsedPagesCount * m_pageSize;
+    }
+
+private:
+    std::size_t m_pageSize;
+    std::size_t m_memorySize;
+    std::unique_ptr<std::byte, decltype(&std::free)> m_memory;
+    MutexLock m_lock;
+    memory::Heap m_heap;
+};
+
+/// Target using malloc() and free().
+class MallocTarget : public Target {
+public:
+    [[nodiscard]] const char* name() const override { return "malloc"; }
+    void* allocate(std::size_t size) override { return std::malloc(size); } // NOLINT
+    void release(void* ptr, std::size_t /*size*/) override { std::free(ptr); } // NOLINT
+    void trim() override { malloc_trim(0); }
+    std::size_t footprint() override { return mallocFootprint(); }
+    double fragmentationIndex() override { return -1.0; }
+};
+
+/// Target using operator new[] and operator delete[].
+class NewTarget : public Target {
+public:
+    [[nodiscard]] const char* name() const override { return "new"; }
+    void* allocate(std::size_t size) override { return new (std::nothrow) std::byte[size]; }
+    void release(void* ptr, std::size_t /*size*/) override { delete[] static_cast<std::byte*>(ptr); }
+    void trim() override { malloc_trim(0); }
+    std::size_t footprint() override { return mallocFootprint(); }
+    double fragmentationIndex() override { return -1.0; }
+};
+
+} // namespace
+
+std::unique_ptr<Target> makeLiballocatorTarget(std::size_t pageSize, std::size_t memorySize, bool threadSafe)
+{
+    auto target = std::make_unique<LiballocatorTarget>(pageSize, memorySize);
+    if (!target->init(threadSafe))
+        return nullptr;
+
+    return target;
+}
+
+std::unique_ptr<Target> makeMallocTarget()
+{
+    return std::make_unique<MallocTarget>();
+}
+
+std::unique_ptr<Target> makeNewTarget()
+{
+    return std::make_unique<NewTarget>();
+}
+
+} // namespace bench
@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <allocator/Heap.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace bench {
+
+/// Represents an allocator, against which allocation traces and benchmarks are run.
+class Target {
+public:
+    /// Default constructor.
+    Target() = default;
+
+    /// Copy constructor.
+    Target(const Target&) = delete;
+
+    /// Move constructor.
+    Target(Target&&) = delete;
+
+    /// Virtual destructor.
+    virtual ~Target() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    Target& operator=(const Target&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    Target& operator=(Target&&) = delete;
+
+    /// Returns the name of the allocator.
+    /// @return Name of the allocator.
+    [[nodiscard]] virtual const char* name() const = 0;
+
+    /// Allocates memory block with the given size.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Allocated memory block or nullptr on error.
+    virtual void* allocate(std::size_t size) = 0;
+
+    /// Releases the given memory block.
+    /// @param ptr          Memory block to be released.
+    /// @param size         Size of the memory block, that was demanded during allocation.
+    virtual void release(void* ptr, std::size_t size) = 0;
+
+    /// Returns the unused memory of this allocator back to the system, if the allocator supports it.
+    virtual void trim() {}
+
+    /// Returns the size of the memory, that is currently taken from the system by this allocator.
+    /// @return Current memory footprint in bytes or 0 if it cannot be measured.
+    virtual std::size_t footprint() = 0;
+
+    /// Returns the highest memory footprint since the creation of this allocator.
+    /// @return Peak memory footprint in bytes or 0 if the allocator does not track it.
+    virtual std::size_t peakFootprint() { return 0; }
+
+    /// Returns the fragmentation index of the free memory.
+    /// @return Fragmentation index in range [0, 1] or a negative value if it cannot be measured.
+    virtual double fragmentationIndex() = 0;
+};
+
+/// Creates the target using a liballocator heap over its own memory region.
+/// @param pageSize     Size of the page to be used by the heap.
+/// @param memorySize   Size of the memory region to be managed by the heap.
+/// @param threadSafe   Flag indicating if the heap should be guarded by a mutex.
+/// @return Created target or nullptr on error.
+std::unique_ptr<Target> makeLiballocatorTarget(std::size_t pageSize, std::size_t memorySize, bool threadSafe = false);
+
+/// Creates the target using malloc() and free().
+/// @return Created target.
+std::unique_ptr<Target> makeMallocTarget();
+
+/// Creates the target using operator new[] and operator delete[].
+/// @return Created target.
+std::unique_ptr<Target> makeNewTarget();
+
+} // namespace bench
@@ -0,0 +1,408 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "PerfCounters.hpp"
+#include "Targets.hpp"
+#include "efficiency/Report.hpp"
+#include "efficiency/Workload.hpp"
+#include "micro/Benchmark.hpp"
+#include "micro/Report.hpp"
+#include "platformInit.hpp"
+#include "replay/Replay.hpp"
+#include "replay/TraceFile.hpp"
+#include "scale/Report.hpp"
+#include "scale/Scenarios.hpp"
+
+#include <allocator/Heap.hpp>
+#include <allocator/Tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t cDefaultPageSize = 4096;
+constexpr std::size_t cDefaultMemorySizeMiB = 256;
+constexpr std::size_t cDefaultEventsCount = 1000000;
+constexpr std::size_t cDefaultSamplesCount = 10;
+constexpr std::size_t cDefaultWarmupCount = 3;
+constexpr std::size_t cDefaultMinRepetitionsCount = 5;
+constexpr std::size_t cDefaultMaxRepetitionsCount = 101;
+constexpr std::size_t cDefaultTimeBudgetMs = 200;
+constexpr std::size_t cScaleMemorySizeMiB = 64;
+constexpr std::size_t cDefaultEfficiencyOpsCount = 2000000;
+constexpr std::size_t cDefaultEfficiencyMemorySizeMiB = 16;
+constexpr std::size_t cEfficiencySamplesCount = 50;
+constexpr std::size_t cMiB = 1024 * 1024;
+
+void showUsage(const char* name)
+{
+    std::printf("Usage:\n");                                                                           // NOLINT
+    std::printf("  %s record <trace> [events] [seed]\n", name);                                        // NOLINT
+    std::printf("      Records synthetic workload with liballocator to the given trace file.\n");     // NOLINT
+    std::printf("  %s replay <trace> [page size] [memory MiB] [samples]\n", name);                     // NOLINT
+    std::printf("      Replays the given trace file against liballocator, malloc and new.\n");        // NOLINT
+    std::printf("  %s micro <results> [max repetitions] [time budget ms]\n", name);                  // NOLINT
+    std::printf("      Runs microbenchmarks and saves results as CSV (*.csv) or JSON (otherwise).\n"); // NOLINT
+    std::printf("  %s scale <results> [max threads]\n", name);                                        // NOLINT
+    std::printf("      Runs multi-threaded scenarios and saves results as CSV (*.csv) or JSON.\n");   // NOLINT
+    std::printf("  %s efficiency <results> [ops] [memory MiB]\n", name);                              // NOLINT
+    std::printf("      Runs long random workloads and saves heap samples as CSV (*.csv) or JSON.\n"); // NOLINT
+}
+
+std::size_t argument(int argc, char* argv[], int idx, std::size_t defaultValue) // NOLINT
+{
+    if (idx >= argc)
+        return defaultValue;
+
+    return std::strtoull(argv[idx], nullptr, 0); // NOLINT
+}
+
+std::uint64_t steadyClock()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+/// Opens the hardware counters and informs the user, if they are not available.
+bool initCounters(bench::PerfCounters& counters)
+{
+    if (counters.init())
+        return true;
+
+    std::printf("Hardware counters are not available, reporting only timings\n"); // NOLINT
+    return false;
+}
+
+/// Records synthetic workload with mostly small, short-lived blocks and some bigger, long-lived ones.
+int record(const char* path, std::size_t eventsCount, std::size_t seed)
+{
+    auto memorySize = cDefaultMemorySizeMiB * cMiB;
+    std::unique_ptr<std::byte, decltype(&std::free)> memory(
+        static_cast<std::byte*>(std::aligned_alloc(cDefaultPageSize, memorySize)),
+        &std::free);
+
+    memory::Heap heap;
+    auto start = std::uintptr_t(memory.get());
+    if (!memory || !heap.init(start, start + memorySize, cDefaultPageSize)) {
+        std::printf("Failed to initialize the heap\n"); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    std::size_t capacity = 1;
+    while (capacity < eventsCount)
+        capacity *= 2;
+
+    std::vector<memory::TraceSlot> slots(capacity);
+    memory::Tracer tracer;
+    if (!tracer.init(slots.data(), slots.size(), steadyClock)) {
+        std::printf("Failed to initialize the tracer\n"); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    heap.setTracer(&tracer);
+
+    constexpr std::size_t cMaxLiveCount = 20000;
+    constexpr double cBigBlockRatio = 0.02;
+    constexpr std::size_t cMaxBigSize = 64 * 1024;
+    constexpr double cSmallSizeMean = 6.0;
+    std::mt19937_64 generator(seed);
+    std::lognormal_distribution<double> smallSize(std::log(cSmallSizeMean * 8), 1.0);
+    std::uniform_int_distribution<std::size_t> bigSize(cDefaultPageSize, cMaxBigSize);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    std::vector<void*> live;
+    while (tracer.recordedCount() < eventsCount) {
+        bool allocate = live.empty() || (live.size() < cMaxLiveCount && chance(generator) < 0.5); // NOLINT
+        if (allocate) {
+            auto size = std::max<std::size_t>(1, std::size_t(smallSize(generator)));
+            if (chance(generator) < cBigBlockRatio)
+                size = bigSize(generator);
+
+            if (auto* ptr = heap.allocate(size))
+                live.push_back(ptr);
+
+            continue;
+        }
+
+        std::uniform_int_distribution<std::size_t> pick(0, live.size() - 1);
+        auto idx = pick(generator);
+        heap.release(live[idx]);
+        live[idx] = live.back();
+        live.pop_back();
+    }
+
+    heap.setTracer(nullptr);
+    if (!bench::saveTrace(path, tracer))
+        return EXIT_FAILURE;
+
+    std::printf("Recorded %zu events to '%s'\n", tracer.recordedCount(), path); // NOLINT
+    return EXIT_SUCCESS;
+}
+
+int replay(const char* path, std::size_t pageSize, std::size_t memorySizeMiB, std::size_t samplesCount)
+{
+    std::vector<memory::TraceEvent> events;
+    if (!bench::loadTrace(path, events))
+        return EXIT_FAILURE;
+
+    std::vector<std::unique_ptr<bench::Target>> targets;
+    targets.push_back(bench::makeLiballocatorTarget(pageSize, memorySizeMiB * cMiB));
+    targets.push_back(bench::makeMallocTarget());
+    targets.push_back(bench::makeNewTarget());
+    if (!targets.front()) {
+        // NOLINTNEXTLINE
+        std::printf("Failed to initialize liballocator with page size %zu and %zu MiB\n", pageSize, memorySizeMiB);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Replaying %zu events from '%s' (page size %zu, %zu MiB)\n", // NOLINT
+                events.size(),
+                path,
+                pageSize,
+                memorySizeMiB);
+
+    bench::PerfCounters counters;
+    auto* perfCounters = initCounters(counters) ? &counters : nullptr;
+
+    std::vector<bench::ReplayResult> results;
+    for (auto& target : targets)
+        results.push_back(bench::replay(events, *target, samplesCount, perfCounters));
+
+    bench::printReplayResults(targets, results);
+    return EXIT_SUCCESS;
+}
+
+bool hasSuffix(const char* str, const char* suffix)
+{
+    auto strLength = std::strlen(str);
+    auto suffixLength = std::strlen(suffix);
+    return strLength >= suffixLength && std::strcmp(str + strLength - suffixLength, suffix) == 0; // NOLINT
+}
+
+/// Runs the microbenchmark sweep against liballocator with each page size, malloc and new.
+int micro(const char* path, std::size_t maxRepetitionsCount, std::size_t timeBudgetMs)
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::fopen(path, "w"), &std::fclose);
+    if (!file) {
+        std::printf("Failed to open '%s'\n", path); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    bench::PerfCounters counters;
+    bool withCounters = initCounters(counters);
+
+    bench::BenchmarkOptions options{cDefaultWarmupCount,
+                                    std::min(cDefaultMinRepetitionsCount, maxRepetitionsCount),
+                                    maxRepetitionsCount,
+                                    double(timeBudgetMs) / 1000.0, // NOLINT
+                                    0,
+                                    withCounters ? &counters : nullptr};
+    auto sweep = bench::defaultSweep();
+    std::vector<bench::BenchmarkResult> results;
+
+    auto run = [&](bench::Target& target, std::size_t pageSize, const bench::BenchmarkConfig& config) {
+        results.push_back(bench::runBenchmark(target, pageSize, config, options));
+        bench::printBenchmarkResult(results.back(), withCounters);
+    };
+
+    bench::printBenchmarkHeader(withCounters);
+    for (auto pageSize : bench::defaultPageSizes()) {
+        for (const auto& config : sweep) {
+            auto memorySize = bench::heapSize(config, pageSize);
+            auto target = bench::makeLiballocatorTarget(pageSize, memorySize);
+            if (!target) {
+                std::printf("Failed to initialize liballocator with page size %zu and %zu bytes\n", // NOLINT
+                            pageSize,
+                            memorySize);
+                return EXIT_FAILURE;
+            }
+
+            run(*target, pageSize, config);
+        }
+    }
+
+    // Page size is not a parameter of system allocators, so they are measured only once.
+    for (auto& target : {bench::makeMallocTarget(), bench::makeNewTarget()}) {
+        for (const auto& config : sweep)
+            run(*target, 0, config);
+    }
+
+    bench::printBenchmarkFooter(withCounters);
+
+    if (hasSuffix(path, ".csv"))
+        bench::writeCsv(file.get(), results);
+    else
+        bench::writeJson(file.get(), results, options);
+
+    std::printf("Saved %zu results to '%s'\n", results.size(), path); // NOLINT
+    return EXIT_SUCCESS;
+}
+
+/// Runs the multi-threaded scenarios against liballocator guarded by a mutex and malloc.
+int scale(const char* path, std::size_t maxThreadsCount)
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::fopen(path, "w"), &std::fclose);
+    if (!file) {
+        std::printf("Failed to open '%s'\n", path); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::unique_ptr<bench::Target>> targets;
+    targets.push_back(bench::makeLiballocatorTarget(cDefaultPageSize, cScaleMemorySizeMiB * cMiB, true));
+    targets.push_back(bench::makeMallocTarget());
+    if (!targets.front()) {
+        std::printf("Failed to initialize liballocator with page size %zu and %zu MiB\n", // NOLINT
+                    cDefaultPageSize,
+                    cScaleMemorySizeMiB);
+        return EXIT_FAILURE;
+    }
+
+    bench::PerfCounters counters;
+    auto* perfCounters = initCounters(counters) ? &counters : nullptr;
+
+    std::vector<bench::ScalingResult> results;
+    for (auto scenario : bench::allScenarios()) {
+        for (auto threadsCount : bench::threadCounts(std::max<std::size_t>(1, maxThreadsCount))) {
+            for (auto& target : targets)
+                results.push_back(bench::runScenario(*target, scenario, threadsCount, 0, perfCounters));
+        }
+    }
+
+    bench::printScalingResults(results);
+
+    if (hasSuffix(path, ".csv"))
+        bench::writeCsv(file.get(), results);
+    else
+        bench::writeJson(file.get(), results);
+
+    std::printf("Saved %zu results to '%s'\n", results.size(), path); // NOLINT
+    return EXIT_SUCCESS;
+}
+
+/// Runs the memory efficiency workload with each page size and fill ratio.
+int efficiency(const char* path, std::size_t opsCount, std::size_t memorySizeMiB)
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::fopen(path, "w"), &std::fclose);
+    if (!file) {
+        std::printf("Failed to open '%s'\n", path); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    constexpr std::size_t cPageSizes[] = {256, 1024, 4096, 16384};
+    constexpr double cFillRatios[] = {0.5, 0.8, 0.95};
+
+    std::vector<bench::EfficiencyResult> results;
+    for (auto pageSize : cPageSizes) {
+        for (auto fillRatio : cFillRatios) {
+            bench::EfficiencyConfig config{pageSize,
+                                           memorySizeMiB * cMiB,
+                                           fillRatio,
+                                           opsCount,
+                                           cEfficiencySamplesCount,
+                                           0};
+            bench::EfficiencyResult result;
+            if (!bench::runEfficiency(config, result)) {
+                std::printf("Failed to initialize liballocator with page size %zu and %zu MiB\n", // NOLINT
+                            pageSize,
+                            memorySizeMiB);
+                return EXIT_FAILURE;
+            }
+
+            results.push_back(std::move(result));
+        }
+    }
+
+    bench::printEfficiencyResults(results);
+
+    if (hasSuffix(path, ".csv"))
+        bench::writeCsv(file.get(), results);
+    else
+        bench::writeJson(file.get(), results);
+
+    std::printf("Saved %zu results to '%s'\n", results.size(), path); // NOLINT
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+// NOLINTNEXTLINE
+int appMain(int argc, char* argv[])
+{
+    if (!platformInit())
+        return EXIT_FAILURE;
+
+    if (argc < 3) {
+        showUsage(argv[0]); // NOLINT
+        return EXIT_FAILURE;
+    }
+
+    const char* command = argv[1]; // NOLINT
+    const char* path = argv[2];    // NOLINT
+
+    if (std::strcmp(command, "record") == 0)
+        return record(path, argument(argc, argv, 3, cDefaultEventsCount), argument(argc, argv, 4, 0));
+
+    if (std::strcmp(command, "replay") == 0) {
+        return replay(path,
+                      argument(argc, argv, 3, cDefaultPageSize),
+                      argument(argc, argv, 4, cDefaultMemorySizeMiB),
+                      argument(argc, argv, 5, cDefaultSamplesCount));
+    }
+
+    if (std::strcmp(command, "micro") == 0) {
+        return micro(path,
+                     argument(argc, argv, 3, cDefaultMaxRepetitionsCount),
+                     argument(argc, argv, 4, cDefaultTimeBudgetMs));
+    }
+
+    if (std::strcmp(command, "scale") == 0)
+        return scale(path, argument(argc, argv, 3, std::thread::hardware_concurrency()));
+
+    if (std::strcmp(command, "efficiency") == 0) {
+        return efficiency(path,
+                          argument(argc, argv, 3, cDefaultEfficiencyOpsCount),
+                          argument(argc, argv, 4, cDefaultEfficiencyMemorySizeMiB));
+    }
+
+    showUsage(argv[0]); // NOLINT
+    return EXIT_FAILURE;
+}
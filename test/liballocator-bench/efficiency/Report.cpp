@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Report.hpp"
+
+#include <allocator/allocator.hpp>
+
+#include <cstddef>
+
+namespace bench {
+namespace {
+
+/// Horizontal line of the table with the efficiency results.
+constexpr const char* cSeparator = "+-------+------+------------+----------+----------+----------+"
+                                   "--------+----------+\n";
+
+constexpr double cKiB = 1024.0;
+constexpr double cPercent = 100.0;
+
+} // namespace
+
+void printEfficiencyResults(const std::vector<EfficiencyResult>& results)
+{
+    std::printf("%s", cSeparator);                                                                        // NOLINT
+    std::printf("|  page | fill |   peak KiB | internal |    total | metadata |   frag | failures |\n"); // NOLINT
+    std::printf("%s", cSeparator);                                                                        // NOLINT
+
+    for (const auto& result : results) {
+        std::printf("| %5zu | %3.0f%% | %10.0f | %7.3fx | %7.3fx | %7.2f%% | %6.3f | %7.3f%% |\n", // NOLINT
+                    result.config.pageSize,
+                    result.config.fillRatio * cPercent,
+                    double(result.peakRequestedSize) / cKiB,
+                    result.internalOverhead,
+                    result.totalOverhead,
+                    result.metadataRatio * cPercent,
+                    result.fragmentationIndex,
+                    result.failureRate * cPercent);
+    }
+
+    std::printf("%s", cSeparator); // NOLINT
+}
+
+void writeJson(std::FILE* file, const std::vector<EfficiencyResult>& results)
+{
+    std::fprintf(file, "{\n");                                                    // NOLINT
+    std::fprintf(file, "  \"version\": \"%s\",\n", memory::allocator::version()); // NOLINT
+    std::fprintf(file, "  \"results\": [\n");                                     // NOLINT
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto& config = result.config;
+        std::fprintf(file, // NOLINT
+                     "    {\"pageSize\": %zu, \"memorySize\": %zu, \"fillRatio\": %.3f, \"opsCount\": %zu, "
+                     "\"totalMemorySize\": %zu, \"userMemorySize\": %zu, \"peakRequestedSize\": %zu, "
+                     "\"internalOverhead\": %.4f, \"totalOverhead\": %.4f, \"metadataRatio\": %.4f, "
+                     "\"fragmentationIndex\": %.4f, \"failureRate\": %.6f,\n",
+                     config.pageSize,
+                     config.memorySize,
+                     config.fillRatio,
+                     config.opsCount,
+                     result.totalMemorySize,
+                     result.userMemorySize,
+                     result.peakRequestedSize,
+                     result.internalOverhead,
+                     result.totalOverhead,
+                     result.metadataRatio,
+                     result.fragmentationIndex,
+                     result.failureRate);
+
+        std::fprintf(file, "     \"samples\": [\n"); // NOLINT
+        for (std::size_t j = 0; j < result.samples.size(); ++j) {
+            const auto& sample = result.samples[j];
+            std::fprintf(file, // NOLINT
+                         "       {\"opIdx\": %zu, \"requestedSize\": %zu, \"allocatedSize\": %zu, "
+                         "\"consumedSize\": %zu, \"reservedSize\": %zu, \"fragmentationIndex\": %.4f, "
+                         "\"allocationsCount\": %zu, \"failedCount\": %zu}%s\n",
+                         sample.opIdx,
+                         sample.requestedSize,
+                         sample.allocatedSize,
+                         sample.consumedSize,
+                         sample.reservedSize,
+                         sample.fragmentationIndex,
+                         sample.allocationsCount,
+                         sample.failedCount,
+                         (j + 1 < result.samples.size()) ? "," : "");
+        }
+
+        std::fprintf(file, "     ]}%s\n", (i + 1 < results.size()) ? "," : ""); // NOLINT
+    }
+
+    std::fprintf(file, "  ]\n"); // NOLINT
+    std::fprintf(file, "}\n");   // NOLINT
+}
+
+void writeCsv(std::FILE* file, const std::vector<EfficiencyResult>& results)
+{
+    std::fprintf(file, // NOLINT
+                 "version,pageSize,memorySize,fillRatio,opIdx,requestedSize,allocatedSize,consumedSize,"
+                 "reservedSize,fragmentationIndex,allocationsCount,failedCount\n");
+
+    for (const auto& result : results) {
+        for (const auto& sample : result.samples) {
+            std::fprintf(file, // NOLINT
+                         "%s,%zu,%zu,%.3f,%zu,%zu,%zu,%zu,%zu,%.4f,%zu,%zu\n",
+                         memory::allocator::version(),
+                         result.config.pageSize,
+                         result.config.memorySize,
+                         result.config.fillRatio,
+                         sample.opIdx,
+                         sample.requestedSize,
+                         sample.allocatedSize,
+                         sample.consumedSize,
+                         sample.reservedSize,
+                         sample.fragmentationIndex,
+                         sample.allocationsCount,
+                         sample.failedCount);
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Workload.hpp"
+
+#include <allocator/Heap.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+
+namespace bench {
+namespace {
+
+constexpr double cSmallRatio = 0.80;
+constexpr double cMediumRatio = 0.17;
+constexpr double cSmallSizeMedian = 40.0;
+constexpr double cSmallSizeSigma = 0.8;
+constexpr std::size_t cMaxSmallSize = 511;
+constexpr std::size_t cMaxMediumSize = 4096;
+constexpr std::size_t cMaxBigSize = 64 * 1024;
+
+constexpr double cShortLifetimeRatio = 0.85;
+constexpr double cMediumLifetimeRatio = 0.13;
+constexpr double cShortLifetime = 1.0;
+constexpr double cMediumLifetime = 30.0;
+constexpr double cLongLifetime = 50.0;
+
+constexpr std::size_t cSizeEstimationCount = 100000;
+
+/// Generates sizes and lifetimes of the blocks allocated by the workload.
+class Generator {
+public:
+    explicit Generator(std::uint64_t seed)
+        : m_generator(seed)
+    {}
+
+    /// Returns the size of the next block.
+    std::size_t size()
+    {
+        auto kind = m_chance(m_generator);
+        if (kind < cSmallRatio)
+            return std::clamp<std::size_t>(std::size_t(m_smallSize(m_generator)), 1, cMaxSmallSize);
+
+        if (kind < cSmallRatio + cMediumRatio)
+            return std::uniform_int_distribution<std::size_t>(cMaxSmallSize + 1, cMaxMediumSize)(m_generator);
+
+        return std::uniform_int_distribution<std::size_t>(cMaxMediumSize + 1, cMaxBigSize)(m_generator);
+    }
+
+    /// Returns the lifetime in allocation steps before scaling.
+    double lifetime()
+    {
+        auto kind = m_chance(m_generator);
+        auto mean = cLongLifetime;
+        if (kind < cShortLifetimeRatio)
+            mean = cShortLifetime;
+        else if (kind < cShortLifetimeRatio + cMediumLifetimeRatio)
+            mean = cMediumLifetime;
+
+        return std::exponential_distribution<double>(1.0 / mean)(m_generator);
+    }
+
+    /// Returns the expected lifetime in allocation steps before scaling.
+    static double meanLifetime()
+    {
+        auto longLifetimeRatio = 1.0 - cShortLifetimeRatio - cMediumLifetimeRatio;
+        return cShortLifetimeRatio * cShortLifetime + cMediumLifetimeRatio * cMediumLifetime
+             + longLifetimeRatio * cLongLifetime;
+    }
+
+private:
+    std::mt19937_64 m_generator;
+    std::uniform_real_distribution<double> m_chance{0.0, 1.0};
+    std::lognormal_distribution<double> m_smallSize{std::log(cSmallSizeMedian), cSmallSizeSigma};
+};
+
+/// Represents the block, that is live in the workload.
+struct LiveBlock {
+    std::size_t deathStep; ///< Allocation step, after which the block is released.
+    void* ptr;             ///< Allocated memory block.
+    std::size_t size;      ///< Demanded size of the block.
+
+    bool operator>(const LiveBlock& other) const { return deathStep > other.deathStep; }
+};
+
+/// Returns the size of the pages, that are currently used in the heap.
+std::size_t usedMemorySize(memory::Heap& heap, std::size_t pageSize)
+{
+    auto stats = heap.getExtendedStats();
+
+    std::size_t usedPagesCount = 0;
+    for (std::size_t i = 0; i < stats.regionsCount; ++i)
+        usedPagesCount += stats.regions.at(i).pagesCount - stats.regions.at(i).freePagesCount;
+
+    return usedPagesCount * pageSize;
+}
+
+/// Computes the summary of the result from the samples in its second half.
+void summarize(EfficiencyResult& result)
+{
+    double requestedSize = 0.0;
+    double allocatedSize = 0.0;
+    double consumedSize = 0.0;
+    double fragmentationIndex = 0.0;
+    std::size_t allocationsCount = 0;
+    std::size_t failedCount = 0;
+    std::size_t steadyCount = 0;
+
+    for (const auto& sample : result.samples) {
+        if (sample.opIdx * 2 <= result.config.opsCount)
+            continue;
+
+        requestedSize += double(sample.requestedSize);
+        allocatedSize += double(sample.allocatedSize);
+        consumedSize += double(sample.consumedSize);
+        fragmentationIndex += sample.fragmentationIndex;
+        allocationsCount += sample.allocationsCount;
+        failedCount += sample.failedCount;
+        ++steadyCount;
+    }
+
+    if (steadyCount == 0 || requestedSize == 0.0)
+        return;
+
+    result.internalOverhead = allocatedSize / requestedSize;
+    result.totalOverhead = consumedSize / requestedSize;
+    result.fragmentationIndex = fragmentationIndex / double(steadyCount);
+    result.failureRate = (allocationsCount != 0) ? double(failedCount) / double(allocationsCount) : 0.0;
+}
+
+} // namespace
+
+bool runEfficiency(const EfficiencyConfig& config, EfficiencyResult& result)
+{
+    result = {};
+    result.config = config;
+
+    std::unique_ptr<std::byte, decltype(&std::free)> memory(
+        static_cast<std::byte*>(std::aligned_alloc(config.pageSize, config.memorySize)),
+        &std::free);
+
+    memory::Heap heap;
+    auto start = std::uintptr_t(memory.get());
+    if (!memory || !heap.init(start, start + config.memorySize, config.pageSize))
+        return false;
+
+    auto stats = heap.getStats();
+    result.totalMemorySize = stats.totalMemorySize;
+    result.userMemorySize = stats.userMemorySize;
+    result.metadataRatio = double(stats.reservedMemorySize) / double(stats.totalMemorySize);
+    auto baseUsedSize = usedMemorySize(heap, config.pageSize);
+
+    // Steady state live size is the mean size times the mean lifetime in allocation steps.
+    Generator generator(config.seed);
+    double meanSize = 0.0;
+    for (std::size_t i = 0; i < cSizeEstimationCount; ++i)
+        meanSize += double(generator.size());
+
+    meanSize /= double(cSizeEstimationCount);
+    auto lifetimeScale = config.fillRatio * double(result.userMemorySize) / (meanSize * Generator::meanLifetime());
+
+    std::priority_queue<LiveBlock, std::vector<LiveBlock>, std::greater<>> live;
+    auto sampleInterval = std::max<std::size_t>(1, config.opsCount / std::max<std::size_t>(1, config.samplesCount));
+    std::size_t requestedSize = 0;
+    std::size_t opIdx = 0;
+    std::size_t step = 0;
+    EfficiencySample interval{};
+
+    auto onOperation = [&] {
+        if (++opIdx % sampleInterval != 0)
+            return;
+
+        auto heapStats = heap.getStats();
+        interval.opIdx = opIdx;
+        interval.requestedSize = requestedSize;
+        interval.allocatedSize = heapStats.allocatedMemorySize;
+        interval.consumedSize = usedMemorySize(heap, config.pageSize) - baseUsedSize;
+        interval.reservedSize = heapStats.reservedMemorySize;
+        interval.fragmentationIndex = heap.fragmentationIndex();
+        result.samples.push_back(interval);
+        interval = {};
+    };
+
+    while (opIdx < config.opsCount) {
+        while (!live.empty() && live.top().deathStep <= step && opIdx < config.opsCount) {
+            heap.release(live.top().ptr);
+            requestedSize -= live.top().size;
+            live.pop();
+            onOperation();
+        }
+
+        if (opIdx >= config.opsCount)
+            break;
+
+        auto size = generator.size();
+        auto lifetime = std::size_t(generator.lifetime() * lifetimeScale);
+        ++interval.allocationsCount;
+        if (auto* ptr = heap.allocate(size)) {
+            live.push({step + lifetime + 1, ptr, size});
+            requestedSize += size;
+            result.peakRequestedSize = std::max(result.peakRequestedSize, requestedSize);
+        }
+        else {
+            ++interval.failedCount;
+        }
+
+        ++step;
+        onOperation();
+    }
+
+    while (!live.empty()) {
+        heap.release(live.top().ptr);
+        live.pop();
+    }
+
+    summarize(result);
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+/// Represents one run of the memory efficiency workload.
+struct EfficiencyConfig {
+    std::size_t pageSize;     ///< Page size used by the heap.
+    std::size_t memorySize;   ///< Size of the memory region managed by the heap.
+    double fillRatio;         ///< Expected size of the live blocks in steady state relative to the user memory.
+    std::size_t opsCount;     ///< Number of allocations and releases in the run.
+    std::size_t samplesCount; ///< Number of samples taken during the run.
+    std::uint64_t seed;       ///< Seed used to generate sizes and lifetimes.
+};
+
+/// Represents the state of the heap sampled during the run.
+struct EfficiencySample {
+    std::size_t opIdx;            ///< Number of operations done before the sample was taken.
+    std::size_t requestedSize;    ///< Total size of the live blocks as demanded by the workload.
+    std::size_t allocatedSize;    ///< Size of the memory allocated by the user as reported by the heap.
+    std::size_t consumedSize;     ///< Size of the used pages, including zone headers and free chunks.
+    std::size_t reservedSize;     ///< Size of the memory reserved for the metadata of the heap.
+    double fragmentationIndex;    ///< Fragmentation index of the free pages.
+    std::size_t allocationsCount; ///< Number of allocations since the previous sample.
+    std::size_t failedCount;      ///< Number of failed allocations since the previous sample.
+};
+
+/// Represents the result of one run of the memory efficiency workload.
+struct EfficiencyResult {
+    EfficiencyConfig config;               ///< Configuration of the run.
+    std::size_t totalMemorySize;           ///< Size of the memory passed to the heap.
+    std::size_t userMemorySize;            ///< Size of the memory available to the user.
+    std::size_t peakRequestedSize;         ///< Highest total size of the live blocks.
+    double internalOverhead;               ///< Allocated size relative to the requested size in steady state.
+    double totalOverhead;                  ///< Consumed size relative to the requested size in steady state.
+    double metadataRatio;                  ///< Reserved size relative to the total memory size.
+    double fragmentationIndex;             ///< Mean fragmentation index of the free pages in steady state.
+    double failureRate;                    ///< Ratio of failed allocations in steady state.
+    std::vector<EfficiencySample> samples; ///< States of the heap sampled over the time.
+};
+
+/// Runs the memory efficiency workload against a new liballocator heap.
+/// @param config       Configuration of the run.
+/// @param result       Result of the run.
+/// @return Flag indicating if the heap could be initialized.
+/// @retval true        Workload was run and the result is valid.
+/// @retval false       Heap could not be initialized with the given configuration.
+/// @note Sizes are mostly small, with some medium blocks and rare big ones spanning many pages. Lifetimes are
+///       mostly short, with some blocks living much longer. Lifetimes are scaled, so that the expected live size
+///       matches the fill ratio. The summary covers only the second half of the run, when the live set has
+///       already reached its steady state.
+bool runEfficiency(const EfficiencyConfig& config, EfficiencyResult& result);
+
+} // namespace bench
@@ -0,0 +1,274 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+
+namespace bench {
+namespace {
+
+/// Represents one allocation or release in the benchmark batch.
+struct Operation {
+    std::uint32_t slot; ///< Index of the block, that is allocated or released.
+    bool allocate;      ///< Flag indicating if the block is allocated or released.
+};
+
+/// Generates the sequence of operations of one batch.
+/// @param config       Point of the sweep, for which operations are generated.
+/// @param seed         Seed used to generate the random orders.
+/// @return Sequence of operations, that leaves no block live at the end.
+std::vector<Operation> makeOperations(const BenchmarkConfig& config, std::uint64_t seed)
+{
+    std::vector<Operation> ops;
+    std::mt19937_64 generator(seed);
+
+    auto count = std::uint32_t(config.liveCount);
+    std::vector<std::uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+
+    switch (config.pattern) {
+        case Pattern::eLifo:
+            for (auto slot : order)
+                ops.push_back({slot, true});
+            for (auto it = order.rbegin(); it != order.rend(); ++it)
+                ops.push_back({*it, false});
+            break;
+
+        case Pattern::eFifo:
+        case Pattern::eRandom:
+            for (auto slot : order)
+                ops.push_back({slot, true});
+            if (config.pattern == Pattern::eRandom)
+                std::shuffle(order.begin(), order.end(), generator);
+            for (auto slot : order)
+                ops.push_back({slot, false});
+            break;
+
+        case Pattern::eRamp: {
+            // Live set grows by one block per step, so it briefly exceeds the demanded count by one in the last step.
+            std::vector<std::uint32_t> live;
+            std::vector<std::uint32_t> freeSlots;
+            std::uint32_t nextSlot = 0;
+            auto takeSlot = [&] {
+                if (freeSlots.empty())
+                    return nextSlot++;
+
+                auto slot = freeSlots.back();
+                freeSlots.pop_back();
+                return slot;
+            };
+
+            while (live.size() < count) {
+                for (int i = 0; i < 2; ++i) {
+                    auto slot = takeSlot();
+                    live.push_back(slot);
+                    ops.push_back({slot, true});
+                }
+
+                std::uniform_int_distribution<std::size_t> pick(0, live.size() - 1);
+                auto idx = pick(generator);
+                ops.push_back({live[idx], false});
+                freeSlots.push_back(live[idx]);
+                live[idx] = live.back();
+                live.pop_back();
+            }
+
+            for (auto slot : live)
+                ops.push_back({slot, false});
+            break;
+        }
+    }
+
+    return ops;
+}
+
+/// Returns the number of blocks addressed by the given operations.
+/// @param ops          Operations to be checked.
+/// @return Number of slots needed to run the operations.
+std::size_t slotsCount(const std::vector<Operation>& ops)
+{
+    std::uint32_t maxSlot = 0;
+    for (const auto& op : ops)
+        maxSlot = std::max(maxSlot, op.slot);
+
+    return ops.empty() ? 0 : maxSlot + 1;
+}
+
+/// Runs one batch of operations.
+/// @param target       Target to run the operations against.
+/// @param ops          Operations to be run.
+/// @param ptrs         Storage for the allocated blocks.
+/// @param size         Size of each allocated block.
+/// @return Number of failed allocations.
+std::size_t runBatch(Target& target, const std::vector<Operation>& ops, std::vector<void*>& ptrs, std::size_t size)
+{
+    std::size_t failedCount = 0;
+    for (const auto& op : ops) {
+        if (op.allocate) {
+            ptrs[op.slot] = target.allocate(size);
+            if (ptrs[op.slot] == nullptr)
+                ++failedCount;
+        }
+        else {
+            target.release(ptrs[op.slot], size);
+        }
+    }
+
+    return failedCount;
+}
+
+/// Returns the given percentile from the sorted values.
+/// @param sorted       Sorted values.
+/// @param percentile   Percentile in range [0, 1].
+/// @return Value of the percentile.
+double percentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    auto idx = std::size_t(percentile * double(sorted.size() - 1));
+    return sorted.at(idx);
+}
+
+} // namespace
+
+const char* toString(Pattern pattern)
+{
+    switch (pattern) {
+        case Pattern::eLifo: return "lifo";
+        case Pattern::eFifo: return "fifo";
+        case Pattern::eRandom: return "random";
+        case Pattern::eRamp: return "ramp";
+    }
+
+    return "unknown";
+}
+
+BenchmarkResult runBenchmark(Target& target,
+                             std::size_t pageSize,
+                             const BenchmarkConfig& config,
+                             const BenchmarkOptions& options)
+{
+    BenchmarkResult result{};
+    result.target = target.name();
+    result.pageSize = pageSize;
+    result.config = config;
+    result.counters = unavailablePerfValues();
+
+    auto ops = makeOperations(config, options.seed);
+    std::vector<void*> ptrs(slotsCount(ops), nullptr);
+    result.opsCount = ops.size();
+    if (ops.empty())
+        return result;
+
+    for (std::size_t i = 0; i < options.warmupCount; ++i)
+        result.failedCount += runBatch(target, ops, ptrs, config.allocSize);
+
+    // Results of a configuration, that does not fit into the target, would measure only the failure path.
+    if (result.failedCount != 0)
+        return result;
+
+    std::vector<double> samples;
+    samples.reserve(options.maxRepetitionsCount);
+    double elapsed = 0.0;
+    if (options.counters != nullptr)
+        options.counters->start();
+
+    while (samples.size() < options.maxRepetitionsCount
+           && (samples.size() < options.minRepetitionsCount || elapsed < options.timeBudget)) {
+        auto start = std::chrono::steady_clock::now();
+        result.failedCount += runBatch(target, ops, ptrs, config.allocSize);
+        auto end = std::chrono::steady_clock::now();
+
+        auto duration = std::chrono::duration<double>(end - start).count();
+        elapsed += duration;
+        samples.push_back(duration * 1e9 / double(ops.size())); // NOLINT
+    }
+
+    result.batchesCount = samples.size();
+    if (options.counters != nullptr)
+        result.counters = perOperation(options.counters->stop(), ops.size() * samples.size());
+
+    std::sort(samples.begin(), samples.end());
+    result.min = percentile(samples, 0.0);
+    result.median = percentile(samples, 0.5); // NOLINT
+    result.p99 = percentile(samples, 0.99);   // NOLINT
+    result.max = percentile(samples, 1.0);
+    return result;
+}
+
+std::size_t heapSize(const BenchmarkConfig& config, std::size_t pageSize)
+{
+    constexpr std::size_t cMinChunkSize = 16;
+    constexpr std::size_t cSlackSize = 1024 * 1024;
+
+    std::size_t blockSize = cMinChunkSize;
+    while (blockSize < config.allocSize)
+        blockSize *= 2;
+
+    if (config.allocSize >= pageSize)
+        blockSize = (config.allocSize + pageSize - 1) / pageSize * pageSize;
+
+    // Twice the live set covers the page descriptors and partially used zones.
+    return 2 * (config.liveCount + 1) * blockSize + cSlackSize;
+}
+
+std::vector<BenchmarkConfig> defaultSweep()
+{
+    constexpr std::size_t cMinAllocSize = 8;
+    constexpr std::size_t cMaxAllocSize = 8192;
+    constexpr std::size_t cLiveCounts[] = {16, 256, 1024};
+    constexpr Pattern cPatterns[] = {Pattern::eLifo, Pattern::eFifo, Pattern::eRandom, Pattern::eRamp};
+
+    std::vector<BenchmarkConfig> sweep;
+    for (auto allocSize = cMinAllocSize; allocSize <= cMaxAllocSize; allocSize *= 2) {
+        for (auto liveCount : cLiveCounts) {
+            for (auto pattern : cPatterns)
+                sweep.push_back({allocSize, liveCount, pattern});
+        }
+    }
+
+    return sweep;
+}
+
+std::vector<std::size_t> defaultPageSizes()
+{
+    return {256, 1024, 4096}; // NOLINT
+}
+
+} // namespace bench
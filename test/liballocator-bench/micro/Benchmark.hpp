@@ -0,0 +1,121 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PerfCounters.hpp"
+#include "Targets.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+/// Represents the order, in which the benchmark allocates and releases the memory blocks.
+enum class Pattern {
+    eLifo,   ///< All blocks are allocated and then released in the reverse order.
+    eFifo,   ///< All blocks are allocated and then released in the order of allocation.
+    eRandom, ///< All blocks are allocated and then released in a random order.
+    eRamp    ///< Each step allocates two blocks and releases a random one until all blocks are live.
+};
+
+/// Returns the name of the given pattern.
+/// @param pattern      Pattern to be converted.
+/// @return Name of the pattern.
+const char* toString(Pattern pattern);
+
+/// Represents one point of the benchmark sweep.
+struct BenchmarkConfig {
+    std::size_t allocSize; ///< Size of each allocated block.
+    std::size_t liveCount; ///< Number of blocks, that are live at the peak of one batch.
+    Pattern pattern;       ///< Order of allocations and releases in one batch.
+};
+
+/// Represents the parameters of the measurement, that are shared by all points of the sweep.
+struct BenchmarkOptions {
+    std::size_t warmupCount;         ///< Number of untimed batches run before the measurement.
+    std::size_t minRepetitionsCount; ///< Number of timed batches, that are always run.
+    std::size_t maxRepetitionsCount; ///< Highest number of timed batches.
+    double timeBudget;               ///< Time in seconds, after which no more batches above the minimum are run.
+    std::uint64_t seed;              ///< Seed used to generate the random orders.
+    PerfCounters* counters;          ///< Hardware counters read around the timed batches or nullptr.
+};
+
+/// Represents the result of one point of the benchmark sweep.
+struct BenchmarkResult {
+    const char* target;      ///< Name of the target.
+    std::size_t pageSize;    ///< Page size used by the target or 0 if it does not apply.
+    BenchmarkConfig config;  ///< Measured point of the sweep.
+    std::size_t opsCount;    ///< Number of allocations and releases in one batch.
+    std::size_t batchesCount; ///< Number of timed batches.
+    std::size_t failedCount; ///< Number of failed allocations. Timings are not valid if this is not 0.
+    double min;              ///< Lowest time of one operation in ns across the batches.
+    double median;           ///< Median time of one operation in ns across the batches.
+    double p99;              ///< 99th percentile of the time of one operation in ns across the batches.
+    double max;              ///< Highest time of one operation in ns across the batches.
+    PerfValues counters;     ///< Hardware counters per operation across the timed batches.
+};
+
+/// Runs one point of the benchmark sweep against the given target.
+/// @param target       Target to be measured.
+/// @param pageSize     Page size used by the target or 0 if it does not apply.
+/// @param config       Point of the sweep to be measured.
+/// @param options      Parameters of the measurement.
+/// @return Result of the measurement.
+/// @note Each batch is timed as a whole and divided by the number of its operations, so the clock overhead is
+///       amortized. The sequence of operations is generated before the measurement and all blocks are released
+///       at the end of each batch, so every batch starts with the same state of the target. Timed batches are
+///       repeated until the time budget is used, but always within the limits given in the options.
+BenchmarkResult runBenchmark(Target& target,
+                             std::size_t pageSize,
+                             const BenchmarkConfig& config,
+                             const BenchmarkOptions& options);
+
+/// Returns the size of the heap, that is used by liballocator for the given point of the sweep.
+/// @param config       Point of the sweep.
+/// @param pageSize     Page size used by liballocator.
+/// @return Size of the heap in bytes.
+/// @note Heap is sized to the live set with some slack instead of using one big heap for all points, because
+///       the cost of splitting and joining free page groups grows with their size. Otherwise results for small
+///       live sets would be dominated by the size of the heap.
+std::size_t heapSize(const BenchmarkConfig& config, std::size_t pageSize);
+
+/// Returns the points of the default benchmark sweep.
+/// @return Points of the sweep: every combination of the size classes, live set sizes and patterns.
+std::vector<BenchmarkConfig> defaultSweep();
+
+/// Returns the page sizes of the default benchmark sweep.
+/// @return Page sizes, for which liballocator is measured.
+std::vector<std::size_t> defaultPageSizes();
+
+} // namespace bench
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Report.hpp"
+
+#include <allocator/allocator.hpp>
+
+#include <cstddef>
+
+namespace bench {
+namespace {
+
+/// Prints the horizontal line of the table with the benchmark results.
+/// @param withCounters     Flag indicating if the table contains hardware counters.
+void printSeparator(bool withCounters)
+{
+    std::printf("+--------------+-------+--------+-------+--------+--------+------+" // NOLINT
+                "----------+----------+----------+----------+");
+    if (withCounters)
+        printPerfSeparator();
+
+    std::printf("\n"); // NOLINT
+}
+
+} // namespace
+
+void printBenchmarkHeader(bool withCounters)
+{
+    printSeparator(withCounters);
+    std::printf("| target       |  page |   size |  live | order  |    ops | runs |" // NOLINT
+                "   min ns |   med ns |   p99 ns |   max ns |");
+    if (withCounters)
+        printPerfHeader();
+
+    std::printf("\n"); // NOLINT
+    printSeparator(withCounters);
+}
+
+void printBenchmarkResult(const BenchmarkResult& result, bool withCounters)
+{
+    if (result.failedCount != 0) {
+        std::printf("| %-12s | %5zu | %6zu | %5zu | %-6s | %6zu | %4zu | %-41s |", // NOLINT
+                    result.target,
+                    result.pageSize,
+                    result.config.allocSize,
+                    result.config.liveCount,
+                    toString(result.config.pattern),
+                    result.opsCount,
+                    result.batchesCount,
+                    "out of memory");
+    }
+    else {
+        std::printf("| %-12s | %5zu | %6zu | %5zu | %-6s | %6zu | %4zu | %8.1f | %8.1f | %8.1f | %8.1f |", // NOLINT
+                    result.target,
+                    result.pageSize,
+                    result.config.allocSize,
+                    result.config.liveCount,
+                    toString(result.config.pattern),
+                    result.opsCount,
+                    result.batchesCount,
+                    result.min,
+                    result.median,
+                    result.p99,
+                    result.max);
+    }
+
+    if (withCounters)
+        printPerfValues(result.counters);
+
+    std::printf("\n"); // NOLINT
+}
+
+void printBenchmarkFooter(bool withCounters)
+{
+    printSeparator(withCounters);
+}
+
+void writeJson(std::FILE* file, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options)
+{
+    auto seed = static_cast<unsigned long long>(options.seed); // NOLINT(google-runtime-int)
+    std::fprintf(file, "{\n");                                                       // NOLINT
+    std::fprintf(file, "  \"version\": \"%s\",\n", memory::allocator::version());    // NOLINT
+    std::fprintf(file, "  \"unit\": \"ns/op\",\n");                                  // NOLINT
+    std::fprintf(file, "  \"warmup\": %zu,\n", options.warmupCount);                 // NOLINT
+    std::fprintf(file, "  \"minRepetitions\": %zu,\n", options.minRepetitionsCount); // NOLINT
+    std::fprintf(file, "  \"maxRepetitions\": %zu,\n", options.maxRepetitionsCount); // NOLINT
+    std::fprintf(file, "  \"timeBudget\": %.3f,\n", options.timeBudget);             // NOLINT
+    std::fprintf(file, "  \"seed\": %llu,\n", seed);                                 // NOLINT
+    std::fprintf(file, "  \"results\": [\n");                                        // NOLINT
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::fprintf(file, // NOLINT
+                     "    {\"target\": \"%s\", \"pageSize\": %zu, \"allocSize\": %zu, \"liveCount\": %zu, "
+                     "\"pattern\": \"%s\", \"opsCount\": %zu, \"batchesCount\": %zu, \"failedCount\": %zu, "
+                     "\"min\": %.3f, \"median\": %.3f, \"p99\": %.3f, \"max\": %.3f",
+                     result.target,
+                     result.pageSize,
+                     result.config.allocSize,
+                     result.config.liveCount,
+                     toString(result.config.pattern),
+                     result.opsCount,
+                     result.batchesCount,
+                     result.failedCount,
+                     result.min,
+                     result.median,
+                     result.p99,
+                     result.max);
+
+        writePerfJson(file, result.counters);
+        std::fprintf(file, "}%s\n", (i + 1 < results.size()) ? "," : ""); // NOLINT
+    }
+
+    std::fprintf(file, "  ]\n"); // NOLINT
+    std::fprintf(file, "}\n");   // NOLINT
+}
+
+void writeCsv(std::FILE* file, const std::vector<BenchmarkResult>& results)
+{
+    std::fprintf(file, // NOLINT
+                 "version,target,pageSize,allocSize,liveCount,pattern,opsCount,batchesCount,failedCount,"
+                 "min,median,p99,max");
+    writePerfCsvHeader(file);
+    std::fprintf(file, "\n"); // NOLINT
+
+    for (const auto& result : results) {
+        std::fprintf(file, // NOLINT
+                     "%s,%s,%zu,%zu,%zu,%s,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.3f",
+                     memory::allocator::version(),
+                     result.target,
+                     result.pageSize,
+                     result.config.allocSize,
+                     result.config.liveCount,
+                     toString(result.config.pattern),
+                     result.opsCount,
+                     result.batchesCount,
+                     result.failedCount,
+                     result.min,
+                     result.median,
+                     result.p99,
+                     result.max);
+
+        writePerfCsv(file, result.counters);
+        std::fprintf(file, "\n"); // NOLINT
+    }
+}
+
+} // namespace bench
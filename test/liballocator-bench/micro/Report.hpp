@@ -0,0 +1,69 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace bench {
+
+/// Prints the header of the table with the benchmark results.
+/// @param withCounters Flag indicating if the hardware counters should be printed.
+void printBenchmarkHeader(bool withCounters);
+
+/// Prints one row of the table with the benchmark results.
+/// @param result       Result to be printed.
+/// @param withCounters Flag indicating if the hardware counters should be printed.
+void printBenchmarkResult(const BenchmarkResult& result, bool withCounters);
+
+/// Prints the footer of the table with the benchmark results.
+/// @param withCounters Flag indicating if the hardware counters should be printed.
+void printBenchmarkFooter(bool withCounters);
+
+/// Writes the benchmark results as a JSON document.
+/// @param file         File to write the results to.
+/// @param results      Results to be written.
+/// @param options      Parameters of the measurement, that produced the results.
+/// @note The document contains the version of liballocator and the measurement parameters, so results of
+///       different versions can be compared by external tools. Hardware counters, that are not available, are null.
+void writeJson(std::FILE* file, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options);
+
+/// Writes the benchmark results as CSV with a header row.
+/// @note Columns of the hardware counters, that are not available, are left empty.
+/// @param file         File to write the results to.
+/// @param results      Results to be written.
+void writeCsv(std::FILE* file, const std::vector<BenchmarkResult>& results);
+
+} // namespace bench
@@ -0,0 +1,293 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace bench {
+namespace {
+
+/// Value marking releases, that have no matching allocation in the trace.
+constexpr std::size_t cNoAllocation = std::numeric_limits<std::size_t>::max();
+
+/// Interval of sampling the footprint, that is used to find its peak.
+constexpr std::size_t cPeakSamplingInterval = 1024;
+
+/// Finds the allocation event matching each release event.
+/// @param events           Events to be matched.
+/// @return Index of the matching allocation event for each release event or cNoAllocation.
+/// @note Matching is done before the replay, so that the replay itself does not allocate any bookkeeping memory.
+std::vector<std::size_t> matchEvents(const std::vector<memory::TraceEvent>& events)
+{
+    std::vector<std::size_t> matches(events.size(), cNoAllocation);
+    std::unordered_map<std::uint64_t, std::size_t> liveAllocations;
+
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        if (event.type == memory::TraceEventType::eAllocate) {
+            liveAllocations[event.address] = i;
+            continue;
+        }
+
+        if (auto it = liveAllocations.find(event.address); it != liveAllocations.end()) {
+            matches[i] = it->second;
+            liveAllocations.erase(it);
+        }
+    }
+
+    return matches;
+}
+
+/// Replays the events once.
+/// @param events           Events to be replayed.
+/// @param matches          Indexes of the allocation events matching each release event.
+/// @param ptrs             Storage for the blocks allocated for each event. It has to be filled with nullptr.
+/// @param target           Target to replay the events against.
+/// @param onEvent          Function called after each replayed event with its index, duration in ns and the change
+///                         of the live size.
+/// @return Number of failed allocations and skipped releases.
+template <typename OnEvent>
+std::pair<std::size_t, std::size_t> replayOnce(const std::vector<memory::TraceEvent>& events,
+                                               const std::vector<std::size_t>& matches,
+                                               std::vector<void*>& ptrs,
+                                               Target& target,
+                                               OnEvent onEvent)
+{
+    std::size_t failedCount = 0;
+    std::size_t skippedCount = 0;
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        if (event.type == memory::TraceEventType::eAllocate) {
+            auto start = std::chrono::steady_clock::now();
+            auto* ptr = target.allocate(event.size);
+            auto end = std::chrono::steady_clock::now();
+
+            ptrs[i] = ptr;
+            if (ptr == nullptr)
+                ++failedCount;
+
+            auto liveChange = (ptr != nullptr) ? std::ptrdiff_t(event.size) : 0;
+            onEvent(i, std::chrono::duration<double, std::nano>(end - start).count(), liveChange);
+            continue;
+        }
+
+        auto allocationIdx = matches[i];
+        if (allocationIdx == cNoAllocation || ptrs[allocationIdx] == nullptr) {
+            ++skippedCount;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        target.release(ptrs[allocationIdx], events[allocationIdx].size);
+        auto end = std::chrono::steady_clock::now();
+
+        ptrs[allocationIdx] = nullptr;
+        auto liveChange = -std::ptrdiff_t(events[allocationIdx].size);
+        onEvent(i, std::chrono::duration<double, std::nano>(end - start).count(), liveChange);
+    }
+
+    for (std::size_t i = 0; i < ptrs.size(); ++i) {
+        if (ptrs[i] != nullptr) {
+            target.release(ptrs[i], events[i].size);
+            ptrs[i] = nullptr;
+        }
+    }
+
+    return {failedCount, skippedCount};
+}
+
+/// Returns the given percentile from the sorted values.
+/// @param sorted           Sorted values.
+/// @param percentile       Percentile in range [0, 1].
+/// @return Value of the percentile.
+double percentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    auto idx = std::size_t(percentile * double(sorted.size() - 1));
+    return sorted.at(idx);
+}
+
+} // namespace
+
+ReplayResult replay(const std::vector<memory::TraceEvent>& events,
+                    Target& target,
+                    std::size_t samplesCount,
+                    PerfCounters* counters)
+{
+    ReplayResult result{};
+    result.eventsCount = events.size();
+    result.counters = unavailablePerfValues();
+
+    auto matches = matchEvents(events);
+    std::vector<void*> ptrs(events.size(), nullptr);
+    std::vector<double> latencies;
+    latencies.reserve(events.size());
+
+    // Bookkeeping of the replay can share the memory with the target, so it is excluded from its footprint.
+    target.trim();
+    auto baseFootprint = target.footprint();
+    auto footprint = [&] { return target.footprint() - std::min(baseFootprint, target.footprint()); };
+
+    auto sampleInterval = std::max<std::size_t>(1, events.size() / std::max<std::size_t>(1, samplesCount));
+    std::size_t liveSize = 0;
+    auto onTimedEvent = [&](std::size_t idx, double latency, std::ptrdiff_t liveChange) {
+        latencies.push_back(latency);
+        liveSize = std::size_t(std::ptrdiff_t(liveSize) + liveChange);
+        result.peakLiveSize = std::max(result.peakLiveSize, liveSize);
+
+        if ((idx + 1) % cPeakSamplingInterval == 0)
+            result.peakFootprint = std::max(result.peakFootprint, footprint());
+
+        if ((idx + 1) % sampleInterval == 0)
+            result.samples.push_back({idx + 1, liveSize, footprint(), target.fragmentationIndex()});
+    };
+
+    std::tie(result.failedCount, result.skippedCount) = replayOnce(events, matches, ptrs, target, onTimedEvent);
+    auto peakFootprint = target.peakFootprint();
+    result.peakFootprint = std::max(result.peakFootprint, peakFootprint - std::min(baseFootprint, peakFootprint));
+
+    std::sort(latencies.begin(), latencies.end());
+    result.latencies = {percentile(latencies, 0.5),   // NOLINT
+                        percentile(latencies, 0.9),   // NOLINT
+                        percentile(latencies, 0.99),  // NOLINT
+                        percentile(latencies, 0.999), // NOLINT
+                        percentile(latencies, 1.0)};
+
+    if (counters != nullptr)
+        counters->start();
+
+    auto start = std::chrono::steady_clock::now();
+    replayOnce(events, matches, ptrs, target, [](std::size_t, double, std::ptrdiff_t) {});
+    auto end = std::chrono::steady_clock::now();
+
+    if (counters != nullptr)
+        result.counters = perOperation(counters->stop(), events.size());
+
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    result.throughput = (seconds > 0.0) ? double(events.size()) / seconds : 0.0;
+    return result;
+}
+
+void printReplayResults(const std::vector<std::unique_ptr<Target>>& targets, const std::vector<ReplayResult>& results)
+{
+    constexpr const char* cSeparator = "+--------------+-------------+----------+----------+----------+----------+"
+                                       "----------+------------+------------+\n";
+    std::printf("%s", cSeparator); // NOLINT
+    std::printf("| %-12s | %11s | %8s | %8s | %8s | %8s | %8s | %10s | %10s |\n", // NOLINT
+                "allocator",
+                "Mops/s",
+                "p50 ns",
+                "p90 ns",
+                "p99 ns",
+                "p99.9 ns",
+                "max ns",
+                "peak KiB",
+                "failed");
+    std::printf("%s", cSeparator); // NOLINT
+
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        const auto& result = results.at(i);
+        std::printf("| %-12s | %11.3f | %8.0f | %8.0f | %8.0f | %8.0f | %8.0f | %10zu | %10zu |\n", // NOLINT
+                    targets.at(i)->name(),
+                    result.throughput / 1e6, // NOLINT
+                    result.latencies[0],
+                    result.latencies[1],
+                    result.latencies[2],
+                    result.latencies[3],
+                    result.latencies[4],
+                    result.peakFootprint / 1024, // NOLINT
+                    result.failedCount);
+    }
+
+    std::printf("%s", cSeparator); // NOLINT
+
+    auto withCounters = std::any_of(results.begin(), results.end(), [](const ReplayResult& result) {
+        return isAvailable(result.counters);
+    });
+
+    if (withCounters) {
+        auto printCountersSeparator = [] {
+            std::printf("+--------------+"); // NOLINT
+            printPerfSeparator();
+            std::printf("\n"); // NOLINT
+        };
+
+        std::printf("\nHardware counters per event:\n"); // NOLINT
+        printCountersSeparator();
+        std::printf("| %-12s |", "allocator"); // NOLINT
+        printPerfHeader();
+        std::printf("\n"); // NOLINT
+        printCountersSeparator();
+
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            std::printf("| %-12s |", targets.at(i)->name()); // NOLINT
+            printPerfValues(results.at(i).counters);
+            std::printf("\n"); // NOLINT
+        }
+
+        printCountersSeparator();
+    }
+
+    if (!results.empty())
+        std::printf("Peak live size: %zu KiB\n\n", results.front().peakLiveSize / 1024); // NOLINT
+
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        std::printf("Fragmentation over time: %s\n", targets.at(i)->name()); // NOLINT
+        // NOLINTNEXTLINE
+        std::printf("%12s %14s %14s %10s %14s\n", "event", "live KiB", "footprint KiB", "overhead", "frag index");
+        for (const auto& sample : results.at(i).samples) {
+            auto overhead = (sample.liveSize != 0) ? double(sample.footprint) / double(sample.liveSize) : 0.0;
+            auto liveSizeKiB = sample.liveSize / 1024;   // NOLINT
+            auto footprintKiB = sample.footprint / 1024; // NOLINT
+            std::printf("%12zu %14zu %14zu %10.3f ", sample.eventIdx, liveSizeKiB, footprintKiB, overhead); // NOLINT
+            if (sample.fragmentationIndex < 0.0)
+                std::printf("%14s\n", "n/a"); // NOLINT
+            else
+                std::printf("%14.3f\n", sample.fragmentationIndex); // NOLINT
+        }
+
+        std::printf("\n"); // NOLINT
+    }
+}
+
+} // namespace bench
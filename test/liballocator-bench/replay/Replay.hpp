@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PerfCounters.hpp"
+#include "Targets.hpp"
+
+#include <allocator/Tracer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace bench {
+
+/// Represents the state of the target sampled during the replay.
+struct ReplaySample {
+    std::size_t eventIdx;      ///< Index of the event, after which the sample was taken.
+    std::size_t liveSize;      ///< Total size of the blocks, that were live at that moment.
+    std::size_t footprint;     ///< Memory footprint of the target.
+    double fragmentationIndex; ///< Fragmentation index of the target.
+};
+
+/// Represents the result of replaying a trace against one target.
+struct ReplayResult {
+    std::size_t eventsCount;                 ///< Number of replayed events.
+    std::size_t failedCount;                 ///< Number of allocations, that failed.
+    std::size_t skippedCount;                ///< Number of releases of blocks, that were not allocated in the replay.
+    double throughput;                       ///< Number of events replayed per second.
+    std::array<double, 5> latencies;         ///< Latency percentiles in ns: p50, p90, p99, p99.9 and max.
+    std::size_t peakLiveSize;                ///< Highest total size of the live blocks.
+    std::size_t peakFootprint;               ///< Highest memory footprint of the target.
+    std::vector<ReplaySample> samples;       ///< States of the target sampled over the time.
+    PerfValues counters;                     ///< Hardware counters per event in the throughput pass.
+};
+
+/// Replays the given events against the given target.
+/// @param events           Events to be replayed.
+/// @param target           Target to replay the events against.
+/// @param samplesCount     Number of samples to be taken during the replay.
+/// @param counters         Hardware counters read during the throughput pass or nullptr.
+/// @return Result of the replay.
+/// @note Events are replayed twice: once with timing of each event for the latencies and once without it for
+///       the throughput. Blocks left live at the end of the trace are released after each pass. Samples and
+///       the peak footprint are taken only in the first pass.
+ReplayResult replay(const std::vector<memory::TraceEvent>& events,
+                    Target& target,
+                    std::size_t samplesCount,
+                    PerfCounters* counters = nullptr);
+
+/// Prints the given results of the replay.
+/// @param targets          Targets, that were used in the replay.
+/// @param results          Results of the replay for each target.
+void printReplayResults(const std::vector<std::unique_ptr<Target>>& targets,
+                        const std::vector<ReplayResult>& results);
+
+} // namespace bench
@@ -0,0 +1,123 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "TraceFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace bench {
+
+bool loadTrace(const char* path, std::vector<memory::TraceEvent>& events)
+{
+    int fd = open(path, O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd < 0) {
+        std::printf("Failed to open trace file '%s'\n", path); // NOLINT
+        return false;
+    }
+
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0 || std::size_t(fileStat.st_size) < sizeof(memory::TraceHeader)) {
+        std::printf("Trace file '%s' is too small\n", path); // NOLINT
+        close(fd);
+        return false;
+    }
+
+    auto size = std::size_t(fileStat.st_size);
+    auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        std::printf("Failed to map trace file '%s'\n", path); // NOLINT
+        return false;
+    }
+
+    memory::TraceHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+
+    bool valid = std::memcmp(header.magic.data(), "LATR", header.magic.size()) == 0 && header.version == 1
+                 && header.eventSize == sizeof(memory::TraceEvent)
+                 && size >= sizeof(header) + header.eventsCount * sizeof(memory::TraceEvent);
+    if (valid) {
+        events.resize(header.eventsCount);
+        std::memcpy(events.data(),
+                    static_cast<const std::byte*>(data) + sizeof(header),
+                    header.eventsCount * sizeof(memory::TraceEvent));
+
+        if (header.droppedCount != 0) {
+            auto droppedCount = static_cast<unsigned long long>(header.droppedCount); // NOLINT(google-runtime-int)
+            std::printf("Trace file '%s' misses %llu oldest events\n", path, droppedCount); // NOLINT
+        }
+    }
+    else {
+        std::printf("Trace file '%s' has invalid format\n", path); // NOLINT
+    }
+
+    munmap(data, size);
+    return valid;
+}
+
+bool saveTrace(const char* path, const memory::Tracer& tracer)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH); // NOLINT
+    if (fd < 0) {
+        std::printf("Failed to create trace file '%s'\n", path); // NOLINT
+        return false;
+    }
+
+    auto size = tracer.exportSize();
+    if (ftruncate(fd, off_t(size)) != 0) {
+        std::printf("Failed to resize trace file '%s'\n", path); // NOLINT
+        close(fd);
+        return false;
+    }
+
+    auto* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        std::printf("Failed to map trace file '%s'\n", path); // NOLINT
+        return false;
+    }
+
+    bool saved = (tracer.exportTrace(data, size) == size);
+    if (!saved)
+        std::printf("Failed to export trace to '%s'\n", path); // NOLINT
+
+    munmap(data, size);
+    return saved;
+}
+
+} // namespace bench
@@ -0,0 +1,204 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Report.hpp"
+
+#include <allocator/allocator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace bench {
+namespace {
+
+/// Prints the horizontal line of the scaling table.
+/// @param targetsCount     Number of targets in the table.
+void printSeparator(std::size_t targetsCount)
+{
+    std::printf("+---------+"); // NOLINT
+    for (std::size_t i = 0; i < targetsCount; ++i)
+        std::printf("---------------------+"); // NOLINT
+
+    std::printf("\n"); // NOLINT
+}
+
+/// Returns the result of the given target, scenario and number of threads.
+/// @param results          Results to be searched.
+/// @param target           Name of the target.
+/// @param scenario         Scenario of the result.
+/// @param threadsCount     Number of threads of the result.
+/// @return Found result or nullptr if there is no such result.
+const ScalingResult* findResult(const std::vector<ScalingResult>& results,
+                                const char* target,
+                                Scenario scenario,
+                                std::size_t threadsCount)
+{
+    auto it = std::find_if(results.begin(), results.end(), [&](const ScalingResult& result) {
+        return std::strcmp(result.target, target) == 0 && result.scenario == scenario
+            && result.threadsCount == threadsCount;
+    });
+
+    return (it != results.end()) ? &*it : nullptr;
+}
+
+/// Prints the hardware counters per operation of the given scenario.
+/// @param results          Results to be printed.
+/// @param scenario         Scenario, which results are printed.
+void printCounters(const std::vector<ScalingResult>& results, Scenario scenario)
+{
+    auto printSeparator = [] {
+        std::printf("+--------------+---------+"); // NOLINT
+        printPerfSeparator();
+        std::printf("\n"); // NOLINT
+    };
+
+    std::printf("\nScenario: %s (hardware counters per operation)\n", toString(scenario)); // NOLINT
+    printSeparator();
+    std::printf("| target       | threads |"); // NOLINT
+    printPerfHeader();
+    std::printf("\n"); // NOLINT
+    printSeparator();
+
+    for (const auto& result : results) {
+        if (result.scenario != scenario)
+            continue;
+
+        std::printf("| %-12s | %7zu |", result.target, result.threadsCount); // NOLINT
+        printPerfValues(result.counters);
+        std::printf("\n"); // NOLINT
+    }
+
+    printSeparator();
+}
+
+} // namespace
+
+void printScalingResults(const std::vector<ScalingResult>& results)
+{
+    std::vector<const char*> targets;
+    std::vector<std::size_t> threadCounts;
+    bool withCounters = false;
+    for (const auto& result : results) {
+        withCounters |= isAvailable(result.counters);
+        auto sameTarget = [&](const char* target) { return std::strcmp(target, result.target) == 0; };
+        if (std::none_of(targets.begin(), targets.end(), sameTarget))
+            targets.push_back(result.target);
+
+        if (std::find(threadCounts.begin(), threadCounts.end(), result.threadsCount) == threadCounts.end())
+            threadCounts.push_back(result.threadsCount);
+    }
+
+    for (auto scenario : allScenarios()) {
+        std::printf("\nScenario: %s (Mops/s and speedup over 1 thread)\n", toString(scenario)); // NOLINT
+        printSeparator(targets.size());
+        std::printf("| threads |"); // NOLINT
+        for (const auto* target : targets)
+            std::printf(" %19s |", target); // NOLINT
+
+        std::printf("\n"); // NOLINT
+        printSeparator(targets.size());
+
+        for (auto threadsCount : threadCounts) {
+            std::printf("| %7zu |", threadsCount); // NOLINT
+            for (const auto* target : targets) {
+                const auto* result = findResult(results, target, scenario, threadsCount);
+                const auto* base = findResult(results, target, scenario, 1);
+                if (result == nullptr || result->failedCount != 0) {
+                    std::printf(" %19s |", (result == nullptr) ? "-" : "out of memory"); // NOLINT
+                    continue;
+                }
+
+                auto speedup = (base != nullptr && base->throughput > 0.0) ? result->throughput / base->throughput
+                                                                           : 0.0;
+                std::printf(" %10.3f %7.2fx |", result->throughput / 1e6, speedup); // NOLINT
+            }
+
+            std::printf("\n"); // NOLINT
+        }
+
+        printSeparator(targets.size());
+        if (withCounters)
+            printCounters(results, scenario);
+    }
+}
+
+void writeJson(std::FILE* file, const std::vector<ScalingResult>& results)
+{
+    std::fprintf(file, "{\n");                                                    // NOLINT
+    std::fprintf(file, "  \"version\": \"%s\",\n", memory::allocator::version()); // NOLINT
+    std::fprintf(file, "  \"unit\": \"ops/s\",\n");                               // NOLINT
+    std::fprintf(file, "  \"results\": [\n");                                     // NOLINT
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::fprintf(file, // NOLINT
+                     "    {\"target\": \"%s\", \"scenario\": \"%s\", \"threadsCount\": %zu, \"opsCount\": %zu, "
+                     "\"failedCount\": %zu, \"throughput\": %.1f",
+                     result.target,
+                     toString(result.scenario),
+                     result.threadsCount,
+                     result.opsCount,
+                     result.failedCount,
+                     result.throughput);
+
+        writePerfJson(file, result.counters);
+        std::fprintf(file, "}%s\n", (i + 1 < results.size()) ? "," : ""); // NOLINT
+    }
+
+    std::fprintf(file, "  ]\n"); // NOLINT
+    std::fprintf(file, "}\n");   // NOLINT
+}
+
+void writeCsv(std::FILE* file, const std::vector<ScalingResult>& results)
+{
+    std::fprintf(file, "version,target,scenario,threadsCount,opsCount,failedCount,throughput"); // NOLINT
+    writePerfCsvHeader(file);
+    std::fprintf(file, "\n"); // NOLINT
+
+    for (const auto& result : results) {
+        std::fprintf(file, // NOLINT
+                     "%s,%s,%s,%zu,%zu,%zu,%.1f",
+                     memory::allocator::version(),
+                     result.target,
+                     toString(result.scenario),
+                     result.threadsCount,
+                     result.opsCount,
+                     result.failedCount,
+                     result.throughput);
+
+        writePerfCsv(file, result.counters);
+        std::fprintf(file, "\n"); // NOLINT
+    }
+}
+
+} // namespace bench
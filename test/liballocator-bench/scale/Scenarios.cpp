@@ -0,0 +1,419 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Scenarios.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace bench {
+namespace {
+
+constexpr std::size_t cCacheLineSize = 64;
+
+constexpr std::size_t cLarsonSlotsCount = 1000;
+constexpr std::size_t cLarsonRoundsCount = 8;
+constexpr std::size_t cLarsonOpsPerRound = 10000;
+constexpr std::size_t cLarsonMinSize = 16;
+constexpr std::size_t cLarsonMaxSize = 512;
+
+constexpr std::size_t cThreadTestIterationsCount = 50;
+constexpr std::size_t cThreadTestBlocksCount = 2000;
+constexpr std::size_t cThreadTestSize = 64;
+
+constexpr std::size_t cProducerConsumerStepsCount = 100000;
+constexpr std::size_t cProducerConsumerSize = 64;
+constexpr std::size_t cRingCapacity = 1024;
+
+constexpr std::size_t cFalseSharingIterationsCount = 20000;
+constexpr std::size_t cFalseSharingWritesCount = 100;
+constexpr std::size_t cFalseSharingSize = 8;
+
+/// Pseudo-random generator, that is cheap enough not to dominate the measured time.
+class XorShift {
+public:
+    explicit XorShift(std::uint64_t seed)
+        : m_state(seed | 1)
+    {}
+
+    std::size_t next(std::size_t min, std::size_t max)
+    {
+        constexpr int cShift1 = 13;
+        constexpr int cShift2 = 7;
+        constexpr int cShift3 = 17;
+
+        m_state ^= m_state << cShift1;
+        m_state ^= m_state >> cShift2;
+        m_state ^= m_state << cShift3;
+        return min + std::size_t(m_state % (max - min + 1));
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+/// Lock-free ring of pointers with one producer and one consumer thread.
+class Ring {
+public:
+    bool push(void* ptr)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size())
+            return false;
+
+        m_slots[tail % m_slots.size()] = ptr;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void* pop()
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        auto* ptr = m_slots[head % m_slots.size()];
+        m_head.store(head + 1, std::memory_order_release);
+        return ptr;
+    }
+
+private:
+    alignas(cCacheLineSize) std::atomic<std::size_t> m_head{0};
+    alignas(cCacheLineSize) std::atomic<std::size_t> m_tail{0};
+    std::array<void*, cRingCapacity> m_slots{};
+};
+
+/// Barrier, that can be reused for consecutive phases of the work.
+class Barrier {
+public:
+    explicit Barrier(std::size_t threadsCount)
+        : m_threadsCount(threadsCount)
+    {}
+
+    void wait()
+    {
+        auto generation = m_generation.load(std::memory_order_acquire);
+        if (m_waitingCount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threadsCount) {
+            m_waitingCount.store(0, std::memory_order_relaxed);
+            m_generation.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+
+        while (m_generation.load(std::memory_order_acquire) == generation)
+            std::this_thread::yield();
+    }
+
+private:
+    std::size_t m_threadsCount;
+    std::atomic<std::size_t> m_waitingCount{0};
+    std::atomic<std::size_t> m_generation{0};
+};
+
+/// Counters of one thread, kept in separate cache lines to avoid false sharing between the threads.
+struct alignas(cCacheLineSize) ThreadCounters {
+    std::size_t opsCount;
+    std::size_t failedCount;
+};
+
+/// Represents one allocated memory block.
+struct Block {
+    void* ptr;
+    std::size_t size;
+};
+
+/// Represents the measurement of the threads run by the scenario.
+struct Measurement {
+    PerfCounters* counters; ///< Hardware counters to be read while the threads run or nullptr.
+    double seconds;         ///< Time from starting the threads until the last of them finishes.
+    PerfValues values;      ///< Values of the hardware counters.
+};
+
+/// Runs the given function in the given number of threads started at the same time.
+/// @param threadsCount     Number of threads to be started.
+/// @param measurement      Measurement of the threads.
+/// @param function         Function to be run with the index of the thread.
+/// @note Counters opened before the threads are created count also the threads, once they finish.
+template <typename Function>
+void runThreads(std::size_t threadsCount, Measurement& measurement, Function function)
+{
+    std::atomic<std::size_t> readyCount{0};
+    std::atomic<bool> start{false};
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount);
+    for (std::size_t i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&, i] {
+            readyCount.fetch_add(1, std::memory_order_acq_rel);
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            function(i);
+        });
+    }
+
+    while (readyCount.load(std::memory_order_acquire) != threadsCount)
+        std::this_thread::yield();
+
+    if (measurement.counters != nullptr)
+        measurement.counters->start();
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& thread : threads)
+        thread.join();
+
+    auto end = std::chrono::steady_clock::now();
+    if (measurement.counters != nullptr)
+        measurement.values = measurement.counters->stop();
+
+    measurement.seconds = std::chrono::duration<double>(end - begin).count();
+}
+
+/// Allocates a block with the given size and counts the operation.
+void* allocate(Target& target, std::size_t size, ThreadCounters& counters)
+{
+    auto* ptr = target.allocate(size);
+    ++counters.opsCount;
+    if (ptr == nullptr)
+        ++counters.failedCount;
+
+    return ptr;
+}
+
+/// Releases the given block and counts the operation.
+void release(Target& target, void* ptr, std::size_t size, ThreadCounters& counters)
+{
+    if (ptr == nullptr)
+        return;
+
+    target.release(ptr, size);
+    ++counters.opsCount;
+}
+
+void larson(Target& target,
+            std::size_t threadsCount,
+            std::uint64_t seed,
+            std::vector<ThreadCounters>& counters,
+            Measurement& measurement)
+{
+    XorShift generator(seed);
+    std::vector<std::vector<Block>> sets(threadsCount);
+    for (auto& set : sets) {
+        for (std::size_t i = 0; i < cLarsonSlotsCount; ++i) {
+            auto size = generator.next(cLarsonMinSize, cLarsonMaxSize);
+            set.push_back({target.allocate(size), size});
+        }
+    }
+
+    // Sets are handed over to the next thread after each round, like connections in a server, so blocks are
+    // often released by other threads than the ones, which allocated them.
+    Barrier barrier(threadsCount);
+    runThreads(threadsCount, measurement, [&](std::size_t threadIdx) {
+        XorShift threadGenerator(seed + threadIdx + 1);
+        for (std::size_t round = 0; round < cLarsonRoundsCount; ++round) {
+            auto& set = sets[(threadIdx + round) % threadsCount];
+            for (std::size_t i = 0; i < cLarsonOpsPerRound; ++i) {
+                auto& block = set[threadGenerator.next(0, set.size() - 1)];
+                release(target, block.ptr, block.size, counters[threadIdx]);
+                block.size = threadGenerator.next(cLarsonMinSize, cLarsonMaxSize);
+                block.ptr = allocate(target, block.size, counters[threadIdx]);
+            }
+
+            barrier.wait();
+        }
+    });
+
+    for (auto& set : sets) {
+        for (auto& block : set)
+            target.release(block.ptr, block.size);
+    }
+}
+
+void threadTest(Target& target,
+                std::size_t threadsCount,
+                std::vector<ThreadCounters>& counters,
+                Measurement& measurement)
+{
+    std::vector<std::vector<void*>> blocks(threadsCount, std::vector<void*>(cThreadTestBlocksCount));
+
+    runThreads(threadsCount, measurement, [&](std::size_t threadIdx) {
+        auto& threadBlocks = blocks[threadIdx];
+        for (std::size_t iteration = 0; iteration < cThreadTestIterationsCount; ++iteration) {
+            for (auto& ptr : threadBlocks)
+                ptr = allocate(target, cThreadTestSize, counters[threadIdx]);
+
+            for (auto* ptr : threadBlocks)
+                release(target, ptr, cThreadTestSize, counters[threadIdx]);
+        }
+    });
+}
+
+void producerConsumer(Target& target,
+                      std::size_t threadsCount,
+                      std::vector<ThreadCounters>& counters,
+                      Measurement& measurement)
+{
+    // Each ring is filled by one thread and drained by its neighbour. With one thread it drains its own ring.
+    std::vector<Ring> rings(threadsCount);
+
+    runThreads(threadsCount, measurement, [&](std::size_t threadIdx) {
+        auto& produced = rings[threadIdx];
+        auto& consumed = rings[(threadIdx + 1) % threadsCount];
+        for (std::size_t step = 0; step < cProducerConsumerStepsCount; ++step) {
+            if (auto* ptr = allocate(target, cProducerConsumerSize, counters[threadIdx])) {
+                if (!produced.push(ptr))
+                    release(target, ptr, cProducerConsumerSize, counters[threadIdx]);
+            }
+
+            release(target, consumed.pop(), cProducerConsumerSize, counters[threadIdx]);
+        }
+    });
+
+    for (auto& ring : rings) {
+        while (auto* ptr = ring.pop())
+            target.release(ptr, cProducerConsumerSize);
+    }
+}
+
+/// Writes to the given block repeatedly, so that sharing its cache line with other threads slows it down.
+void scratch(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    auto* bytes = static_cast<volatile char*>(ptr);
+    for (std::size_t i = 0; i < cFalseSharingWritesCount; ++i)
+        bytes[i % cFalseSharingSize] = char(bytes[i % cFalseSharingSize] + 1); // NOLINT
+}
+
+void falseSharing(Target& target,
+                  std::size_t threadsCount,
+                  bool passive,
+                  std::vector<ThreadCounters>& counters,
+                  Measurement& measurement)
+{
+    // In the passive variant blocks handed to the threads are allocated next to each other by one thread. Blocks
+    // allocated later by the threads can be placed in the same cache lines, if the allocator reuses them.
+    std::vector<void*> initialBlocks(threadsCount, nullptr);
+    if (passive) {
+        for (auto& ptr : initialBlocks)
+            ptr = target.allocate(cFalseSharingSize);
+    }
+
+    runThreads(threadsCount, measurement, [&](std::size_t threadIdx) {
+        if (auto* ptr = initialBlocks[threadIdx]) {
+            scratch(ptr);
+            release(target, ptr, cFalseSharingSize, counters[threadIdx]);
+        }
+
+        for (std::size_t iteration = 0; iteration < cFalseSharingIterationsCount; ++iteration) {
+            auto* ptr = allocate(target, cFalseSharingSize, counters[threadIdx]);
+            scratch(ptr);
+            release(target, ptr, cFalseSharingSize, counters[threadIdx]);
+        }
+    });
+}
+
+} // namespace
+
+const char* toString(Scenario scenario)
+{
+    switch (scenario) {
+        case Scenario::eLarson: return "larson";
+        case Scenario::eThreadTest: return "threadtest";
+        case Scenario::eProducerConsumer: return "prodcons";
+        case Scenario::eActiveFalse: return "active-false";
+        case Scenario::ePassiveFalse: return "passive-false";
+    }
+
+    return "unknown";
+}
+
+ScalingResult runScenario(Target& target,
+                          Scenario scenario,
+                          std::size_t threadsCount,
+                          std::uint64_t seed,
+                          PerfCounters* counters)
+{
+    ScalingResult result{};
+    result.target = target.name();
+    result.scenario = scenario;
+    result.threadsCount = threadsCount;
+    result.counters = unavailablePerfValues();
+    if (threadsCount == 0)
+        return result;
+
+    std::vector<ThreadCounters> threadCounters(threadsCount, ThreadCounters{});
+    Measurement measurement{counters, 0.0, unavailablePerfValues()};
+    switch (scenario) {
+        case Scenario::eLarson: larson(target, threadsCount, seed, threadCounters, measurement); break;
+        case Scenario::eThreadTest: threadTest(target, threadsCount, threadCounters, measurement); break;
+        case Scenario::eProducerConsumer: producerConsumer(target, threadsCount, threadCounters, measurement); break;
+        case Scenario::eActiveFalse: falseSharing(target, threadsCount, false, threadCounters, measurement); break;
+        case Scenario::ePassiveFalse: falseSharing(target, threadsCount, true, threadCounters, measurement); break;
+    }
+
+    for (const auto& counts : threadCounters) {
+        result.opsCount += counts.opsCount;
+        result.failedCount += counts.failedCount;
+    }
+
+    result.throughput = (measurement.seconds > 0.0) ? double(result.opsCount) / measurement.seconds : 0.0;
+    result.counters = perOperation(measurement.values, result.opsCount);
+    return result;
+}
+
+std::vector<Scenario> allScenarios()
+{
+    return {Scenario::eLarson,
+            Scenario::eThreadTest,
+            Scenario::eProducerConsumer,
+            Scenario::eActiveFalse,
+            Scenario::ePassiveFalse};
+}
+
+std::vector<std::size_t> threadCounts(std::size_t maxThreadsCount)
+{
+    std::vector<std::size_t> counts;
+    for (std::size_t count = 1; count < maxThreadsCount; count *= 2)
+        counts.push_back(count);
+
+    counts.push_back(maxThreadsCount);
+    return counts;
+}
+
+} // namespace bench
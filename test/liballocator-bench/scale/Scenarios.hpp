@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PerfCounters.hpp"
+#include "Targets.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+/// Represents the multi-threaded workload, that is run against the target.
+enum class Scenario {
+    eLarson,           ///< Threads replace random blocks in their sets, which are handed over to other threads.
+    eThreadTest,       ///< Each thread repeatedly allocates a batch of blocks and then releases all of them.
+    eProducerConsumer, ///< Each thread allocates blocks, that are released by its neighbour thread.
+    eActiveFalse,      ///< Each thread allocates small blocks and writes to them repeatedly before releasing.
+    ePassiveFalse      ///< Same as eActiveFalse, but the first block of each thread is allocated by the main thread.
+};
+
+/// Returns the name of the given scenario.
+/// @param scenario     Scenario to be converted.
+/// @return Name of the scenario.
+const char* toString(Scenario scenario);
+
+/// Represents the result of running one scenario with the given number of threads.
+struct ScalingResult {
+    const char* target;       ///< Name of the target.
+    Scenario scenario;        ///< Scenario, that was run.
+    std::size_t threadsCount; ///< Number of threads, that were running the scenario.
+    std::size_t opsCount;     ///< Total number of allocations and releases done by all threads.
+    std::size_t failedCount;  ///< Number of failed allocations.
+    double throughput;        ///< Number of operations per second.
+    PerfValues counters;      ///< Hardware counters per operation summed over all threads.
+};
+
+/// Runs the given scenario against the given target.
+/// @param target       Target to run the scenario against. It has to be thread-safe.
+/// @param scenario     Scenario to be run.
+/// @param threadsCount Number of threads to run the scenario.
+/// @param seed         Seed used to generate random sizes and orders.
+/// @param counters     Hardware counters read while the threads run or nullptr.
+/// @return Result of the run.
+/// @note Each thread does the same amount of work regardless of the number of threads, so perfect scaling means
+///       throughput growing linearly with the number of threads. All threads start at the same time and the
+///       throughput is measured until the last of them finishes.
+ScalingResult runScenario(Target& target,
+                          Scenario scenario,
+                          std::size_t threadsCount,
+                          std::uint64_t seed,
+                          PerfCounters* counters = nullptr);
+
+/// Returns all scenarios.
+/// @return All scenarios in the order of declaration.
+std::vector<Scenario> allScenarios();
+
+/// Returns the numbers of threads to be measured.
+/// @param maxThreadsCount  Highest number of threads.
+/// @return Powers of 2 below the given number followed by the number itself.
+std::vector<std::size_t> threadCounts(std::size_t maxThreadsCount);
+
+} // namespace bench
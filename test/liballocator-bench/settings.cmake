@@ -0,0 +1,5 @@
+if (NOT PLATFORM MATCHES "^linux")
+    message(FATAL_ERROR "'liballocator-bench' is supported only on Linux platforms!")
+endif ()
+
+set(APP_CXX_FLAGS                   "${APP_CXX_FLAGS} -fno-exceptions" CACHE INTERNAL "")
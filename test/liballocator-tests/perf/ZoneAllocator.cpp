@@ -0,0 +1,229 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <PageAllocator.hpp>
+#include <TestUtils.hpp>
+#include <ZoneAllocator.hpp>
+#include <allocator/Region.hpp>
+#include <allocator/ZonePolicy.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace memory {
+
+struct FragmentationSample {
+    std::size_t liveBytes = 0;
+    std::size_t usedPages = 0;
+};
+
+static void perfShowFragmentation(const std::vector<FragmentationSample>& firstFit,
+                                  const std::vector<FragmentationSample>& fullestFirst,
+                                  std::size_t pageSize,
+                                  std::size_t sampleInterval)
+{
+    std::printf("+------------+-------------+-----------------------+-----------------------+\n"); // NOLINT
+    std::printf("| %-10s | %-11s | %-21s | %-21s |\n", "operation", "live bytes", "first fit", "fullest first");
+    std::printf("+------------+-------------+-----------------------+-----------------------+\n"); // NOLINT
+    for (std::size_t i = 0; i < firstFit.size(); ++i) {
+        auto liveBytes = double(firstFit[i].liveBytes);
+        auto firstFitBytes = double(firstFit[i].usedPages * pageSize);
+        auto fullestFirstBytes = double(fullestFirst[i].usedPages * pageSize);
+
+        // NOLINTNEXTLINE
+        std::printf("| %10zu | %11zu | %5zu pages (%6.2f%%) | %5zu pages (%6.2f%%) |\n",
+                    (i + 1) * sampleInterval,
+                    firstFit[i].liveBytes,
+                    firstFit[i].usedPages,
+                    (liveBytes > 0.0) ? 100.0 * liveBytes / firstFitBytes : 0.0, // NOLINT
+                    fullestFirst[i].usedPages,
+                    (liveBytes > 0.0) ? 100.0 * liveBytes / fullestFirstBytes : 0.0); // NOLINT
+    }
+    std::printf("+------------+-------------+-----------------------+-----------------------+\n"); // NOLINT
+}
+
+static std::vector<FragmentationSample> perfFragmentationRun(ZonePolicy policy,
+                                                             std::size_t pageSize,
+                                                             std::size_t operationsCount,
+                                                             std::size_t sampleInterval)
+{
+    constexpr std::size_t cPagesCount = 4096;
+    auto size = pageSize * cPagesCount;
+    auto memory = test::alignedAlloc(pageSize, size);
+
+    std::array<Region, 2> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    PageAllocator pageAllocator;
+    REQUIRE(pageAllocator.init(regions.data(), pageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, pageSize));
+    zoneAllocator.setPolicy(policy);
+
+    // Random generator has a fixed seed, so that both policies replay the same workload.
+    constexpr unsigned int cSeed = 0x5eed;
+    std::mt19937 randomGenerator(cSeed);
+    std::uniform_int_distribution<std::size_t> sizeDistribution(1, pageSize / 4);
+
+    std::vector<std::pair<void*, std::size_t>> live;
+    std::vector<FragmentationSample> samples;
+    std::size_t liveBytes = 0;
+
+    for (std::size_t i = 1; i <= operationsCount; ++i) {
+        // Live set grows during the first half of the run and shrinks during the second one.
+        constexpr std::size_t cAllocPercentage = 52;
+        std::size_t allocPercentage = (i < operationsCount / 2) ? cAllocPercentage : 100 - cAllocPercentage;
+        constexpr std::size_t cPercentage = 100;
+        bool shouldAllocate = live.empty() || (randomGenerator() % cPercentage) < allocPercentage;
+
+        if (shouldAllocate) {
+            auto allocSize = sizeDistribution(randomGenerator);
+            if (auto* ptr = zoneAllocator.allocate(allocSize)) {
+                live.emplace_back(ptr, allocSize);
+                liveBytes += allocSize;
+            }
+        }
+        else {
+            auto idx = randomGenerator() % live.size();
+            zoneAllocator.release(live[idx].first);
+            liveBytes -= live[idx].second;
+            live[idx] = live.back();
+            live.pop_back();
+        }
+
+        if (i % sampleInterval == 0) {
+            auto stats = zoneAllocator.getStats();
+            samples.push_back({liveBytes, stats.usedMemorySize / pageSize});
+        }
+    }
+
+    for (auto& [ptr, allocSize] : live)
+        zoneAllocator.release(ptr);
+
+    return samples;
+}
+
+TEST_CASE("Fragmentation over time", "[perf][ZoneAllocator]")
+{
+    constexpr std::size_t cOperationsCount = 2000000;
+    constexpr std::size_t cSampleInterval = 100000;
+
+    for (std::size_t pageSize : {256U, 4096U}) {
+        auto firstFit = perfFragmentationRun(ZonePolicy::eFirstFit, pageSize, cOperationsCount, cSampleInterval);
+        auto fullestFirst
+            = perfFragmentationRun(ZonePolicy::eFullestFirst, pageSize, cOperationsCount, cSampleInterval);
+        REQUIRE(firstFit.size() == fullestFirst.size());
+
+        std::printf("Fragmentation over time (page size: %zu B, live bytes / used zone pages)\n", pageSize); // NOLINT
+        perfShowFragmentation(firstFit, fullestFirst, pageSize, cSampleInterval);
+    }
+}
+
+static double perfColouredTraversal(bool colouring)
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    std::array<Region, 2> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    PageAllocator pageAllocator;
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+    zoneAllocator.setColouring(colouring);
+
+    // Fill zones completely and remember the lowest chunk of each zone. Without colouring all of them have the same
+    // offset within their pages, so they map to the same cache set.
+    constexpr std::size_t cAllocSize = 64;
+    constexpr std::size_t cZonesCount = 128;
+    std::vector<void*> ptrs;
+    std::map<std::uintptr_t, std::uintptr_t> firstChunks;
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+    while (pageAllocator.getStats().freePagesCount + cZonesCount != freePagesCount) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+
+        auto pageAddr = std::uintptr_t(ptr) & ~(cPageSize - 1);
+        auto it = firstChunks.find(pageAddr);
+        if (it == firstChunks.end() || it->second > std::uintptr_t(ptr))
+            firstChunks[pageAddr] = std::uintptr_t(ptr);
+    }
+
+    std::vector<volatile std::size_t*> objects;
+    for (auto& [pageAddr, chunkAddr] : firstChunks) {
+        auto* object = reinterpret_cast<volatile std::size_t*>(chunkAddr);
+        *object = 1;
+        objects.push_back(object);
+    }
+
+    // Traverse the same objects many times and measure the average access time.
+    constexpr std::size_t cRepetitions = 100000;
+    std::size_t sum = 0;
+    auto start = test::currentTime();
+    for (std::size_t i = 0; i < cRepetitions; ++i) {
+        for (auto* object : objects)
+            sum += *object;
+    }
+    auto end = test::currentTime();
+    REQUIRE(sum == cRepetitions * objects.size());
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    constexpr double cNsInUs = 1000.0;
+    return cNsInUs * test::toMicroseconds(end - start) / double(cRepetitions * objects.size());
+}
+
+TEST_CASE("Traversal of the first chunks in zones of the same size", "[perf][ZoneAllocator]")
+{
+    auto withoutColouring = perfColouredTraversal(false);
+    auto withColouring = perfColouredTraversal(true);
+
+    std::printf("+--------------------------------+-------------+\n");                         // NOLINT
+    std::printf("| %-30s |   access    |\n", "128x 64 bytes (first in zone)");                  // NOLINT
+    std::printf("+--------------------------------+-------------+\n");                         // NOLINT
+    std::printf("| %30s | %8.4f ns |\n", "without colouring", withoutColouring);               // NOLINT
+    std::printf("| %30s | %8.4f ns |\n", "with colouring", withColouring);                     // NOLINT
+    std::printf("+--------------------------------+-------------+\n");                         // NOLINT
+}
+
+} // namespace memory
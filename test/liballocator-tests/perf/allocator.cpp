@@ -31,6 +31,7 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 #include <TestUtils.hpp>
+#include <allocator/Tracer.hpp>
 #include <allocator/allocator.hpp>
 
 #include <catch2/catch.hpp>
@@ -41,6 +42,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <random>
+#include <vector>
 
 struct PerfStats {
     double liballocatorAlloc = 0.0;
@@ -295,4 +297,48 @@ TEST_CASE("2000x random number of bytes", "[perf][allocator]")
     perfShowStats(stats, "2000x random number of bytes");
 }
 
+TEST_CASE("Overhead of tracing 1000000x 64 bytes", "[perf][allocator]")
+{
+    constexpr std::size_t cAllocSize = 64;
+    constexpr int cAllocationsCount = 1000000;
+
+    // Initialize liballocator.
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 535;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr std::size_t cTraceCapacity = 65536;
+    std::vector<TraceSlot> slots(cTraceCapacity);
+    Tracer tracer;
+    REQUIRE(tracer.init(slots.data(), slots.size(), [] {
+        return std::uint64_t(test::currentTime().time_since_epoch().count());
+    }));
+
+    auto measure = [&] {
+        auto start = test::currentTime();
+        for (int i = 0; i < cAllocationsCount; ++i) {
+            auto* ptr = allocator::allocate(cAllocSize);
+            allocator::release(ptr);
+        }
+
+        return test::toMicroseconds(test::currentTime() - start) * 1000.0 / double(2 * cAllocationsCount);
+    };
+
+    auto plainTime = measure();
+    allocator::defaultHeap().setTracer(&tracer);
+    auto tracedTime = measure();
+    allocator::defaultHeap().setTracer(nullptr);
+    REQUIRE(tracer.recordedCount() == std::size_t(2 * cAllocationsCount));
+
+    std::printf("+--------------------------------+-------------+\n");                // NOLINT
+    std::printf("| %-30s |   per op    |\n", "Overhead of tracing");                  // NOLINT
+    std::printf("+--------------------------------+-------------+\n");                // NOLINT
+    std::printf("| %30s | %8.2f ns |\n", "without tracer", plainTime);                // NOLINT
+    std::printf("| %30s | %8.2f ns |\n", "with tracer", tracedTime);                  // NOLINT
+    std::printf("| %30s | %8.2f ns |\n", "tracing overhead", tracedTime - plainTime); // NOLINT
+    std::printf("+--------------------------------+-------------+\n");                // NOLINT
+}
+
 } // namespace memory
@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("Arena is properly initialized", "[unit][Arena]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    Arena arena;
+    REQUIRE(arena.allocate(1) == nullptr);
+    REQUIRE(!arena.init(nullptr, cPageSize));
+    REQUIRE(!arena.init(&heap, 0));
+    REQUIRE(arena.init(&heap, cPageSize));
+    REQUIRE(arena.blocksCount() == 0);
+    REQUIRE(arena.allocate(0) == nullptr);
+
+    REQUIRE(arena.allocate(1));
+    REQUIRE(arena.blocksCount() == 1);
+    REQUIRE(heap.getStats().allocatedMemorySize == cPageSize);
+
+    REQUIRE(arena.init(&heap, 2 * cPageSize));
+    REQUIRE(arena.blocksCount() == 0);
+    REQUIRE(heap.getStats().allocatedMemorySize == 0);
+}
+
+TEST_CASE("Arena bump-allocates memory blocks from heap pages", "[unit][Arena]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto start = std::uintptr_t(memory.get());
+
+    Heap heap;
+    REQUIRE(heap.init(start, start + size, cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cBlockSize = 4 * cPageSize;
+    Arena arena;
+    REQUIRE(arena.init(&heap, cBlockSize));
+
+    SECTION("Consecutive allocations are adjacent and aligned")
+    {
+        constexpr std::size_t cAllocSize = 24;
+        auto* ptr1 = static_cast<std::byte*>(arena.allocate(cAllocSize, 8));
+        auto* ptr2 = static_cast<std::byte*>(arena.allocate(cAllocSize, 8));
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(ptr2 == ptr1 + cAllocSize);
+        REQUIRE(std::uintptr_t(ptr1) >= start);
+        REQUIRE(std::uintptr_t(ptr1) < start + size);
+
+        constexpr std::size_t cAlignment = 64;
+        auto* ptr3 = arena.allocate(1, cAlignment);
+        REQUIRE(ptr3);
+        REQUIRE(std::uintptr_t(ptr3) % cAlignment == 0);
+        REQUIRE(arena.blocksCount() == 1);
+    }
+
+    SECTION("New blocks are reserved when the current one is exhausted")
+    {
+        constexpr std::size_t cAllocSize = 48;
+        constexpr std::size_t cAllocationsCount = 200;
+        std::vector<void*> ptrs;
+        for (std::size_t i = 0; i < cAllocationsCount; ++i) {
+            auto* ptr = arena.allocate(cAllocSize);
+            REQUIRE(ptr);
+            std::memset(ptr, int(i), cAllocSize);
+            ptrs.push_back(ptr);
+        }
+
+        REQUIRE(arena.blocksCount() > 1);
+        REQUIRE(arena.blocksCount() <= (cAllocationsCount * cAllocSize) / (cBlockSize / 2));
+        for (std::size_t i = 0; i < cAllocationsCount; ++i)
+            REQUIRE(*static_cast<unsigned char*>(ptrs.at(i)) == static_cast<unsigned char>(i));
+
+        arena.reset();
+        REQUIRE(arena.blocksCount() == 0);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+
+    SECTION("Allocations bigger than the block size get their own block")
+    {
+        auto* small = arena.allocate(cPageSize);
+        auto* big = arena.allocate(2 * cBlockSize);
+        REQUIRE(small);
+        REQUIRE(big);
+        REQUIRE(arena.blocksCount() == 2);
+        std::memset(big, 0, 2 * cBlockSize);
+
+        REQUIRE(arena.allocate(size) == nullptr);
+        REQUIRE(arena.blocksCount() == 2);
+    }
+
+    SECTION("Allocations fail when the heap is exhausted")
+    {
+        while (arena.allocate(cPageSize) != nullptr)
+            ;
+
+        REQUIRE(heap.largestFreeBlock() < cBlockSize);
+        arena.reset();
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+}
+
+TEST_CASE("Arena rolls back to the given mark", "[unit][Arena]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    Arena arena;
+    REQUIRE(arena.init(&heap, cPageSize));
+
+    SECTION("Rollback within the current block reuses the memory")
+    {
+        REQUIRE(arena.allocate(16));
+        auto mark = arena.mark();
+        auto* ptr = arena.allocate(32);
+        REQUIRE(ptr);
+        REQUIRE(arena.allocate(32));
+
+        arena.rollback(mark);
+        REQUIRE(arena.allocate(32) == ptr);
+        REQUIRE(arena.blocksCount() == 1);
+    }
+
+    SECTION("Rollback releases blocks reserved after the mark")
+    {
+        REQUIRE(arena.allocate(16));
+        auto outerMark = arena.mark();
+        auto* ptr = arena.allocate(16);
+        REQUIRE(ptr);
+
+        auto innerMark = arena.mark();
+        constexpr std::size_t cAllocationsCount = 64;
+        for (std::size_t i = 0; i < cAllocationsCount; ++i)
+            REQUIRE(arena.allocate(64));
+
+        auto blocksCount = arena.blocksCount();
+        REQUIRE(blocksCount > 2);
+
+        arena.rollback(innerMark);
+        REQUIRE(arena.blocksCount() == 1);
+        for (std::size_t i = 0; i < cAllocationsCount; ++i)
+            REQUIRE(arena.allocate(64));
+
+        REQUIRE(arena.blocksCount() == blocksCount);
+
+        arena.rollback(outerMark);
+        REQUIRE(arena.blocksCount() == 1);
+        REQUIRE(arena.allocate(16) == ptr);
+    }
+
+    SECTION("Rollback to the mark taken before any allocation releases everything")
+    {
+        auto mark = arena.mark();
+        constexpr std::size_t cAllocationsCount = cPagesCount / 4;
+        for (std::size_t i = 0; i < cAllocationsCount; ++i)
+            REQUIRE(arena.allocate(128));
+
+        arena.rollback(mark);
+        REQUIRE(arena.blocksCount() == 0);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+}
+
+} // namespace memory
@@ -0,0 +1,526 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/allocator.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace memory {
+namespace {
+
+/// Lock, that counts how many times it was acquired and checks, that it is never acquired recursively.
+class CountingLock : public HeapLock {
+public:
+    void lock() override
+    {
+        REQUIRE(!m_locked);
+        m_locked = true;
+        ++m_lockCount;
+    }
+
+    void unlock() override
+    {
+        REQUIRE(m_locked);
+        m_locked = false;
+    }
+
+    [[nodiscard]] bool locked() const { return m_locked; }
+    [[nodiscard]] std::size_t lockCount() const { return m_lockCount; }
+
+private:
+    bool m_locked{};
+    std::size_t m_lockCount{};
+};
+
+} // namespace
+
+TEST_CASE("Heap is properly initialized and destroyed", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    auto stats = heap.getStats();
+    REQUIRE(stats.totalMemorySize == 0);
+    REQUIRE(stats.allocatedMemorySize == 0);
+
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    stats = heap.getStats();
+    REQUIRE(stats.totalMemorySize == size);
+    REQUIRE(stats.allocatedMemorySize == 0);
+    REQUIRE(stats.freeMemorySize == stats.userMemorySize);
+
+    constexpr std::size_t cAllocationsCount = 100;
+    constexpr std::size_t cAllocationSize = 24;
+    for (std::size_t i = 0; i < cAllocationsCount; ++i)
+        REQUIRE(heap.allocate(cAllocationSize));
+
+    REQUIRE(heap.getStats().allocatedMemorySize != 0);
+
+    heap.destroy();
+    stats = heap.getStats();
+    REQUIRE(stats.totalMemorySize == 0);
+    REQUIRE(stats.allocatedMemorySize == 0);
+    REQUIRE(heap.allocate(cAllocationSize) == nullptr);
+
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    stats = heap.getStats();
+    REQUIRE(stats.allocatedMemorySize == 0);
+    REQUIRE(stats.freeMemorySize == stats.userMemorySize);
+}
+
+TEST_CASE("Heaps are independent of each other", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory1 = test::alignedAlloc(cPageSize, size);
+    auto memory2 = test::alignedAlloc(cPageSize, size);
+    auto start1 = std::uintptr_t(memory1.get());
+    auto start2 = std::uintptr_t(memory2.get());
+
+    Heap heap1;
+    Heap heap2;
+    REQUIRE(heap1.init(start1, start1 + size, cPageSize));
+    REQUIRE(heap2.init(start2, start2 + size, cPageSize));
+
+    constexpr std::size_t cAllocationsCount = 64;
+    constexpr std::array<std::size_t, 4> cSizes = {16, 48, 100, 300};
+    std::vector<void*> ptrs1;
+    std::vector<void*> ptrs2;
+    for (std::size_t i = 0; i < cAllocationsCount; ++i) {
+        auto allocSize = cSizes.at(i % cSizes.size());
+        auto* ptr1 = heap1.allocate(allocSize);
+        auto* ptr2 = heap2.allocate(allocSize);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(std::uintptr_t(ptr1) >= start1);
+        REQUIRE(std::uintptr_t(ptr1) < start1 + size);
+        REQUIRE(std::uintptr_t(ptr2) >= start2);
+        REQUIRE(std::uintptr_t(ptr2) < start2 + size);
+        ptrs1.push_back(ptr1);
+        ptrs2.push_back(ptr2);
+    }
+
+    auto stats2 = heap2.getStats();
+    for (auto* ptr : ptrs1)
+        heap1.release(ptr);
+
+    REQUIRE(heap1.getStats().allocatedMemorySize == 0);
+    REQUIRE(heap2.getStats().allocatedMemorySize == stats2.allocatedMemorySize);
+
+    heap2.destroy();
+    REQUIRE(heap1.allocate(cSizes[0]));
+    REQUIRE(heap1.getStats().allocatedMemorySize != 0);
+}
+
+TEST_CASE("Heap acquires its lock around each operation", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 16;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    CountingLock lock;
+    Heap heap;
+    heap.setLock(&lock);
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    REQUIRE(lock.lockCount() == 1);
+
+    constexpr std::size_t cAllocationSize = 32;
+    auto* ptr = heap.allocate(cAllocationSize);
+    REQUIRE(ptr);
+    REQUIRE(lock.lockCount() == 2);
+
+    heap.release(ptr);
+    REQUIRE(lock.lockCount() == 3);
+
+    [[maybe_unused]] auto stats = heap.getStats();
+    REQUIRE(lock.lockCount() == 4);
+
+    heap.destroy();
+    REQUIRE(lock.lockCount() == 5);
+    REQUIRE(!lock.locked());
+
+    heap.setLock(nullptr);
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    REQUIRE(heap.allocate(cAllocationSize));
+    REQUIRE(lock.lockCount() == 5);
+}
+
+TEST_CASE("Heap reports the largest free block and reserves memory", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.largestFreeBlock() == 0);
+    REQUIRE(heap.fragmentationIndex() == 0.0);
+    REQUIRE(heap.tryReserve(cPageSize) == nullptr);
+
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    auto stats = heap.getStats();
+    auto largestFreeBlock = heap.largestFreeBlock();
+    REQUIRE(largestFreeBlock != 0);
+    REQUIRE(largestFreeBlock % cPageSize == 0);
+    REQUIRE(heap.fragmentationIndex() == 0.0);
+
+    SECTION("Reservation bigger than the largest free block fails without side effects")
+    {
+        REQUIRE(heap.tryReserve(largestFreeBlock + 1) == nullptr);
+        REQUIRE(heap.largestFreeBlock() == largestFreeBlock);
+        REQUIRE(heap.getStats().freeMemorySize == stats.freeMemorySize);
+    }
+
+    SECTION("Reservation of the largest free block succeeds")
+    {
+        auto* ptr = heap.tryReserve(largestFreeBlock);
+        REQUIRE(ptr);
+        REQUIRE(std::uintptr_t(ptr) % cPageSize == 0);
+        REQUIRE(heap.largestFreeBlock() == 0);
+
+        heap.release(ptr);
+        REQUIRE(heap.largestFreeBlock() == largestFreeBlock);
+        REQUIRE(heap.getStats().freeMemorySize == stats.freeMemorySize);
+    }
+
+    SECTION("Fragmentation is reported after releasing a block in the middle")
+    {
+        constexpr std::size_t cBlockPagesCount = 4;
+        constexpr std::size_t cBlockSize = cBlockPagesCount * cPageSize;
+        auto* ptr1 = heap.tryReserve(cBlockSize - 1);
+        auto* ptr2 = heap.tryReserve(cBlockSize);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+
+        heap.release(ptr1);
+        auto remainingSize = largestFreeBlock - 2 * cBlockSize;
+        REQUIRE(heap.largestFreeBlock() == remainingSize);
+        REQUIRE(heap.fragmentationIndex() == Approx(1.0 - double(remainingSize) / double(remainingSize + cBlockSize)));
+
+        // Released blocks are joined only, when a bigger block is demanded, and querying doesn't join them.
+        heap.release(ptr2);
+        REQUIRE(heap.largestFreeBlock() == remainingSize);
+
+        auto* ptr = heap.tryReserve(largestFreeBlock);
+        REQUIRE(ptr);
+        heap.release(ptr);
+        REQUIRE(heap.largestFreeBlock() == largestFreeBlock);
+        REQUIRE(heap.fragmentationIndex() == 0.0);
+    }
+}
+
+TEST_CASE("Heap places small blocks in fast memory and overflows to slower one", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cFastPagesCount = 8;
+    constexpr std::size_t cNormalPagesCount = 64;
+    auto fastSize = cPageSize * cFastPagesCount;
+    auto normalSize = cPageSize * cNormalPagesCount;
+    auto fastMemory = test::alignedAlloc(cPageSize, fastSize);
+    auto normalMemory = test::alignedAlloc(cPageSize, normalSize);
+    auto fastStart = std::uintptr_t(fastMemory.get());
+    auto normalStart = std::uintptr_t(normalMemory.get());
+
+    std::array<Region, 3> regions = {{{normalStart, normalSize, Tier::eNormal},
+                                      {fastStart, fastSize, Tier::eFast},
+                                      {0, 0}}};
+
+    Heap heap;
+    REQUIRE(heap.init(regions.data(), cPageSize));
+
+    auto isFast = [&](void* ptr) {
+        return std::uintptr_t(ptr) >= fastStart && std::uintptr_t(ptr) < fastStart + fastSize;
+    };
+
+    auto stats = heap.getExtendedStats();
+    REQUIRE(stats.regions.at(0).tier == Tier::eNormal);
+    REQUIRE(stats.regions.at(1).tier == Tier::eFast);
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eFast)).pagesCount == cFastPagesCount);
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eNormal)).pagesCount == cNormalPagesCount);
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eSlow)).pagesCount == 0);
+
+    constexpr std::size_t cSmallSize = 32;
+    constexpr std::size_t cLargeSize = 2 * cPageSize;
+    auto* small = heap.allocate(cSmallSize);
+    auto* large = heap.allocate(cLargeSize);
+    auto* fastLarge = heap.allocate(cLargeSize, Tier::eFast);
+    REQUIRE(small);
+    REQUIRE(large);
+    REQUIRE(fastLarge);
+    REQUIRE(isFast(small));
+    REQUIRE(!isFast(large));
+    REQUIRE(isFast(fastLarge));
+
+    std::vector<void*> ptrs;
+    while (isFast(ptrs.empty() ? small : ptrs.back())) {
+        auto* ptr = heap.allocate(cSmallSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    stats = heap.getExtendedStats();
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eFast)).freePagesCount == 0);
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eFast)).fallbacksCount != 0);
+
+    for (auto* ptr : ptrs)
+        heap.release(ptr);
+
+    heap.release(small);
+    heap.release(large);
+    heap.release(fastLarge);
+    REQUIRE(heap.getStats().allocatedMemorySize == 0);
+
+    stats = heap.getExtendedStats();
+    auto normalFreePagesCount = stats.regions.at(0).freePagesCount;
+    REQUIRE(stats.tiers.at(std::size_t(Tier::eNormal)).freePagesCount == normalFreePagesCount);
+
+    // All free pages of the tier can be taken at once, after the released groups are joined.
+    auto* normalBlock = heap.allocate(normalFreePagesCount * cPageSize, Tier::eNormal);
+    REQUIRE(normalBlock);
+    REQUIRE(!isFast(normalBlock));
+    heap.release(normalBlock);
+
+    stats = heap.getExtendedStats();
+    REQUIRE(stats.regions.at(0).freePagesCount == normalFreePagesCount);
+    REQUIRE(stats.regions.at(0).largestFreeGroupSize == normalFreePagesCount);
+}
+
+TEST_CASE("Heap allocates blocks with demanded capabilities", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPlainPagesCount = 64;
+    constexpr std::size_t cDmaPagesCount = 32;
+    auto plainSize = cPageSize * cPlainPagesCount;
+    auto dmaSize = cPageSize * cDmaPagesCount;
+    auto plainMemory = test::alignedAlloc(cPageSize, plainSize);
+    auto dmaMemory = test::alignedAlloc(cPageSize, dmaSize);
+    auto dmaStart = std::uintptr_t(dmaMemory.get());
+
+    std::array<Region, 3> regions = {{{std::uintptr_t(plainMemory.get()), plainSize},
+                                      {dmaStart, dmaSize, Tier::eNormal, Caps::eDma},
+                                      {0, 0}}};
+
+    Heap heap;
+    REQUIRE(heap.init(regions.data(), cPageSize));
+
+    auto isDma = [&](void* ptr) {
+        return std::uintptr_t(ptr) >= dmaStart && std::uintptr_t(ptr) < dmaStart + dmaSize;
+    };
+
+    constexpr std::array<std::size_t, 6> cSizes = {16, 24, 64, 200, 600, 1024};
+    std::vector<void*> ptrs;
+    for (auto size : cSizes) {
+        auto* plainPtr = heap.allocate(size);
+        auto* dmaPtr = heap.allocate(size, Caps::eDma);
+        REQUIRE(plainPtr);
+        REQUIRE(dmaPtr);
+        REQUIRE(isDma(dmaPtr));
+        ptrs.push_back(plainPtr);
+        ptrs.push_back(dmaPtr);
+
+        constexpr std::size_t cBoundary = 1024;
+        auto* boundedPtr = heap.allocate(size, Caps::eDma, cBoundary);
+        REQUIRE(boundedPtr);
+        REQUIRE(isDma(boundedPtr));
+        REQUIRE(std::uintptr_t(boundedPtr) / cBoundary == (std::uintptr_t(boundedPtr) + size - 1) / cBoundary);
+        ptrs.push_back(boundedPtr);
+    }
+
+    REQUIRE(heap.allocate(cSizes.at(1), Caps::eDma, cSizes.at(0)) == nullptr);
+    REQUIRE(heap.allocate(cSizes.at(1), Caps::eNonCacheable) == nullptr);
+    REQUIRE(heap.getExtendedStats().regions.at(1).caps == Caps::eDma);
+
+    for (auto* ptr : ptrs)
+        heap.release(ptr);
+
+    REQUIRE(heap.getStats().allocatedMemorySize == 0);
+}
+
+TEST_CASE("Heap serves reserved allocations after its pages are exhausted", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(!heap.reserve(64, 1));
+    REQUIRE(heap.allocateReserved(64) == nullptr);
+
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr std::size_t cAllocSize = 64;
+    constexpr std::size_t cReservedCount = 8;
+    REQUIRE(heap.reserve(cAllocSize, cReservedCount));
+
+    while (heap.tryReserve(cPageSize) != nullptr)
+        ;
+
+    while (heap.allocate(cAllocSize) != nullptr)
+        ;
+
+    for (std::size_t i = 0; i < cReservedCount; ++i)
+        REQUIRE(heap.allocateReserved(cAllocSize));
+
+    auto stats = heap.getExtendedStats();
+    for (std::size_t i = 0; i < stats.sizeClassesCount; ++i) {
+        const auto& sizeClassStats = stats.sizeClasses.at(i);
+        REQUIRE(sizeClassStats.reservedChunksCount == ((sizeClassStats.chunkSize == cAllocSize) ? cReservedCount : 0));
+        REQUIRE(sizeClassStats.pinnedChunksCount >= sizeClassStats.reservedChunksCount);
+    }
+}
+
+TEST_CASE("Heap queues deferred releases until they are drained", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    CountingLock lock;
+    Heap heap;
+    heap.setLock(&lock);
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    REQUIRE(heap.drain(1) == 0);
+    auto allocatedMemorySize = heap.getStats().allocatedMemorySize;
+
+    constexpr std::size_t cBlocksCount = 10;
+    constexpr std::array<std::size_t, 3> cAllocSizes = {8, 64, 2 * cPageSize};
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cBlocksCount; ++i) {
+        auto* ptr = heap.allocate(cAllocSizes.at(i % cAllocSizes.size()));
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    // Queueing never touches the lock nor the heap state.
+    auto lockCount = lock.lockCount();
+    auto stats = heap.getStats();
+    for (auto* ptr : ptrs)
+        heap.releaseDeferred(ptr);
+
+    heap.releaseDeferred(nullptr);
+    REQUIRE(lock.lockCount() == lockCount + 1);
+    REQUIRE(heap.getStats().allocatedMemorySize == stats.allocatedMemorySize);
+
+    constexpr std::size_t cBudget = 4;
+    REQUIRE(heap.drain(cBudget) == cBudget);
+    REQUIRE(heap.getStats().allocatedMemorySize < stats.allocatedMemorySize);
+
+    // Blocks queued after the partial drain are released together with the remaining ones.
+    auto* ptr = heap.allocate(cAllocSizes.at(0));
+    REQUIRE(ptr);
+    heap.releaseDeferred(ptr);
+
+    REQUIRE(heap.drain(cBlocksCount) == cBlocksCount - cBudget + 1);
+    REQUIRE(heap.drain(cBlocksCount) == 0);
+    REQUIRE(heap.getStats().allocatedMemorySize == allocatedMemorySize);
+    REQUIRE(!lock.locked());
+
+    // Blocks, that are not drained, are dropped together with the heap.
+    heap.releaseDeferred(heap.allocate(cAllocSizes.at(1)));
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    REQUIRE(heap.drain(cBlocksCount) == 0);
+}
+
+TEST_CASE("Heap allocates blocks from size classes selected at compile time", "[unit][Heap]")
+{
+    static_assert(Heap::sizeClassIdx(0) == 0);
+    static_assert(Heap::sizeClassIdx(8) == 0);
+    static_assert(Heap::sizeClassIdx(9) == 1);
+    static_assert(Heap::sizeClassIdx(2048) == allocator::cMaxSizeClassesCount - 1);
+    static_assert(Heap::sizeClassIdx(2049) == allocator::cMaxSizeClassesCount);
+
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.allocateFromSizeClass(Heap::sizeClassIdx(32), 32) == nullptr);
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    REQUIRE(heap.allocateFromSizeClass(0, 0) == nullptr);
+
+    constexpr std::size_t cSmallSize = 48;
+    auto* small = heap.allocateFromSizeClass(Heap::sizeClassIdx(cSmallSize), cSmallSize);
+    REQUIRE(small);
+    REQUIRE(std::uintptr_t(small) % 64 == 0);
+    REQUIRE(heap.getStats().allocatedMemorySize == 64);
+
+    // Size classes not smaller than the page are served with whole pages.
+    constexpr std::size_t cBigSize = 300;
+    auto* big = heap.allocateFromSizeClass(Heap::sizeClassIdx(cBigSize), cBigSize);
+    REQUIRE(big);
+    REQUIRE(std::uintptr_t(big) % cPageSize == 0);
+    REQUIRE(heap.getStats().allocatedMemorySize == 64 + 2 * cPageSize);
+
+    heap.release(small);
+    heap.release(big);
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Free functions use the default heap", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 16;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr std::size_t cAllocationSize = 32;
+    auto* ptr = allocator::allocate(cAllocationSize);
+    REQUIRE(ptr);
+    REQUIRE(allocator::defaultHeap().getStats().allocatedMemorySize == allocator::getStats().allocatedMemorySize);
+
+    allocator::defaultHeap().release(ptr);
+    REQUIRE(allocator::getStats().allocatedMemorySize == 0);
+
+    allocator::clear();
+}
+
+} // namespace memory
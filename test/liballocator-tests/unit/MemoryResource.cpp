@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("HeapResource allocates aligned memory from the heap", "[unit][MemoryResource]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto start = std::uintptr_t(memory.get());
+
+    Heap heap;
+    REQUIRE(heap.init(start, start + size, cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    HeapResource resource(&heap);
+    REQUIRE(resource.heap() == &heap);
+    REQUIRE(resource.is_equal(resource));
+    REQUIRE(!resource.is_equal(*std::pmr::new_delete_resource()));
+
+    SECTION("Blocks are aligned to the demanded alignment")
+    {
+        for (std::size_t alignment = 1; alignment <= cPageSize; alignment *= 2) {
+            auto* ptr = resource.allocate(1, alignment);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) >= start);
+            REQUIRE(std::uintptr_t(ptr) < start + size);
+            REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+            resource.deallocate(ptr, 1, alignment);
+        }
+
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+
+    SECTION("Containers release their memory to the heap")
+    {
+        {
+            std::pmr::vector<std::uint32_t> values(&resource);
+            constexpr std::size_t cValuesCount = 200;
+            for (std::size_t i = 0; i < cValuesCount; ++i)
+                values.push_back(std::uint32_t(i));
+
+            REQUIRE(heap.getStats().allocatedMemorySize >= cValuesCount * sizeof(std::uint32_t));
+            for (std::size_t i = 0; i < cValuesCount; ++i)
+                REQUIRE(values.at(i) == i);
+        }
+
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+}
+
+TEST_CASE("ArenaResource allocates memory from the arena", "[unit][MemoryResource]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    Arena arena;
+    REQUIRE(arena.init(&heap, cPageSize));
+
+    ArenaResource resource(&arena);
+    REQUIRE(resource.arena() == &arena);
+    REQUIRE(resource.is_equal(resource));
+    REQUIRE(!resource.is_equal(*std::pmr::new_delete_resource()));
+
+    auto* ptr1 = resource.allocate(0, 1);
+    auto* ptr2 = resource.allocate(0, 1);
+    REQUIRE(ptr1);
+    REQUIRE(ptr2);
+    REQUIRE(ptr1 != ptr2);
+
+    constexpr std::size_t cAlignment = 64;
+    auto* ptr3 = resource.allocate(1, cAlignment);
+    REQUIRE(ptr3);
+    REQUIRE(std::uintptr_t(ptr3) % cAlignment == 0);
+
+    {
+        auto mark = arena.mark();
+        std::pmr::vector<std::uint64_t> values(&resource);
+        constexpr std::size_t cValuesCount = 100;
+        for (std::size_t i = 0; i < cValuesCount; ++i)
+            values.push_back(i);
+
+        REQUIRE(arena.blocksCount() > 1);
+        REQUIRE(values.back() == cValuesCount - 1);
+        values = {};
+        arena.rollback(mark);
+        REQUIRE(arena.blocksCount() == 1);
+    }
+
+    arena.reset();
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+} // namespace memory
@@ -0,0 +1,319 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/ObjectCache.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace memory {
+namespace {
+
+/// Number of objects currently initialized by initObject().
+int initializedCount = 0; // NOLINT
+
+/// Fills the given 64 bytes object with a known pattern.
+void initObject(void* object)
+{
+    std::memset(object, 0xa5, 64);
+    ++initializedCount;
+}
+
+/// Marks the given object as finalized.
+void finiObject(void* /*unused*/)
+{
+    --initializedCount;
+}
+
+/// Object counting its constructions and destructions.
+struct Counted {
+    Counted() { ++count; }
+    Counted(const Counted&) = delete;
+    Counted(Counted&&) = delete;
+    ~Counted() { --count; }
+    Counted& operator=(const Counted&) = delete;
+    Counted& operator=(Counted&&) = delete;
+
+    static inline int count = 0; // NOLINT
+    std::uint64_t value{42};
+};
+
+} // namespace
+
+TEST_CASE("Cache is properly initialized", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    Cache cache;
+    REQUIRE(cache.allocate() == nullptr);
+    REQUIRE(!cache.init(nullptr, "test", 64, 8));
+    REQUIRE(!cache.init(&heap, "test", 0, 8));
+    REQUIRE(!cache.init(&heap, "test", 64, 3));
+    REQUIRE(!cache.init(&heap, "test", 64, 2 * cPageSize));
+    REQUIRE(!cache.init(&heap, "test", size, 8));
+    REQUIRE(!cache.init(&heap, "test", size / 4, 8));
+    REQUIRE(!cache.init(&heap, "test", std::numeric_limits<std::size_t>::max(), 8));
+    REQUIRE(!cache.init(&heap, "test", std::numeric_limits<std::size_t>::max() / 16, 8));
+    REQUIRE(cache.init(&heap, "test", 64, 8));
+
+    auto stats = cache.getStats();
+    REQUIRE(std::strcmp(stats.name, "test") == 0);
+    REQUIRE(stats.objectSize == 64);
+    REQUIRE(stats.slabSize % cPageSize == 0);
+    REQUIRE(stats.slabsCount == 0);
+    REQUIRE(stats.objectsCount == 0);
+}
+
+TEST_CASE("Cache keeps objects initialized between uses", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto start = std::uintptr_t(memory.get());
+
+    Heap heap;
+    REQUIRE(heap.init(start, start + size, cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cObjectSize = 64;
+    constexpr std::size_t cAlignment = 32;
+    initializedCount = 0;
+    Cache cache;
+    REQUIRE(cache.init(&heap, "objects", cObjectSize, cAlignment, initObject, finiObject));
+
+    SECTION("Objects are initialized once per slab")
+    {
+        auto* object = static_cast<unsigned char*>(cache.allocate());
+        REQUIRE(object);
+        REQUIRE(std::uintptr_t(object) % cAlignment == 0);
+        REQUIRE(std::uintptr_t(object) >= start);
+        REQUIRE(std::uintptr_t(object) < start + size);
+        REQUIRE(object[0] == 0xa5);
+        REQUIRE(object[cObjectSize - 1] == 0xa5);
+
+        auto stats = cache.getStats();
+        REQUIRE(stats.slabsCount == 1);
+        REQUIRE(stats.initsCount == stats.objectsCount);
+        REQUIRE(initializedCount == int(stats.objectsCount));
+
+        object[0] = 0x11;
+        cache.release(object);
+        auto* reused = static_cast<unsigned char*>(cache.allocate());
+        REQUIRE(reused == object);
+        REQUIRE(reused[0] == 0x11);
+        REQUIRE(cache.getStats().initsCount == stats.initsCount);
+        cache.release(reused);
+    }
+
+    SECTION("Slabs are added and released as needed")
+    {
+        constexpr std::size_t cObjectsCount = 64;
+        std::vector<void*> objects;
+        for (std::size_t i = 0; i < cObjectsCount; ++i) {
+            auto* object = cache.allocate();
+            REQUIRE(object);
+            REQUIRE(std::uintptr_t(object) % cAlignment == 0);
+            std::memset(object, int(i), cObjectSize);
+            objects.push_back(object);
+        }
+
+        for (std::size_t i = 0; i < cObjectsCount; ++i)
+            REQUIRE(*static_cast<unsigned char*>(objects.at(i)) == static_cast<unsigned char>(i));
+
+        auto stats = cache.getStats();
+        REQUIRE(stats.slabsCount > 1);
+        REQUIRE(stats.objectsCount >= cObjectsCount);
+        REQUIRE(stats.liveObjectsCount == cObjectsCount);
+        REQUIRE(stats.peakObjectsCount == cObjectsCount);
+        REQUIRE(stats.allocationsCount == cObjectsCount);
+        REQUIRE(initializedCount == int(stats.objectsCount));
+
+        for (auto* object : objects)
+            cache.release(object);
+
+        stats = cache.getStats();
+        REQUIRE(stats.slabsCount == 1);
+        REQUIRE(stats.liveObjectsCount == 0);
+        REQUIRE(stats.peakObjectsCount == cObjectsCount);
+        REQUIRE(stats.releasesCount == cObjectsCount);
+        REQUIRE(initializedCount == int(stats.objectsCount));
+
+        cache.trim();
+        REQUIRE(cache.getStats().slabsCount == 0);
+        REQUIRE(initializedCount == 0);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+
+    SECTION("Allocations fail when the heap is exhausted")
+    {
+        std::vector<void*> objects;
+        for (auto* object = cache.allocate(); object != nullptr; object = cache.allocate())
+            objects.push_back(object);
+
+        REQUIRE(!objects.empty());
+        auto slabSize = cache.getStats().slabSize;
+        REQUIRE(heap.allocate(slabSize, Caps::eNone, slabSize) == nullptr);
+
+        for (auto* object : objects)
+            cache.release(object);
+    }
+
+    REQUIRE(cache.clear());
+    REQUIRE(initializedCount == 0);
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Cache is not cleared while its objects are allocated", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cObjectSize = 64;
+    initializedCount = 0;
+    {
+        Cache cache;
+        REQUIRE(cache.init(&heap, "objects", cObjectSize, 8, initObject, finiObject));
+
+        auto* object = static_cast<unsigned char*>(cache.allocate());
+        REQUIRE(object);
+        object[0] = 0x11;
+
+        REQUIRE(!cache.clear());
+        REQUIRE(!cache.init(&heap, "other", cObjectSize, 8));
+        REQUIRE(initializedCount == int(cache.getStats().objectsCount));
+        REQUIRE(cache.getStats().liveObjectsCount == 1);
+        REQUIRE(object[0] == 0x11);
+
+        cache.release(object);
+        REQUIRE(cache.clear());
+        REQUIRE(initializedCount == 0);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+
+        REQUIRE(cache.init(&heap, "objects", cObjectSize, 8, initObject, finiObject));
+        object = static_cast<unsigned char*>(cache.allocate());
+        REQUIRE(object);
+    }
+
+    // Slab of the object, that was not released, is left to the heap untouched.
+    REQUIRE(initializedCount != 0);
+    REQUIRE(heap.getStats().freeMemorySize < freeMemorySize);
+}
+
+TEST_CASE("Cache stores small objects densely", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr std::size_t cObjectSize = 16;
+    Cache cache;
+    REQUIRE(cache.init(&heap, "small", cObjectSize, cObjectSize));
+
+    std::vector<void*> objects;
+    for (std::size_t i = 0; i < 3 * cPageSize / cObjectSize; ++i) {
+        auto* object = cache.allocate();
+        REQUIRE(object);
+        REQUIRE(std::uintptr_t(object) % cObjectSize == 0);
+        objects.push_back(object);
+    }
+
+    // Objects are not preceded by headers, so they are placed right next to each other.
+    auto stats = cache.getStats();
+    REQUIRE(stats.slabSize == cPageSize);
+    REQUIRE(stats.objectsCount * cObjectSize > stats.slabsCount * stats.slabSize / 2);
+    REQUIRE(std::uintptr_t(objects.at(1)) - std::uintptr_t(objects.at(0)) == cObjectSize);
+
+    // Objects are released in the reversed order, so each of them is found through its own slab.
+    for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+        cache.release(*it);
+
+    REQUIRE(cache.getStats().liveObjectsCount == 0);
+    REQUIRE(cache.getStats().slabsCount == 1);
+    REQUIRE(cache.clear());
+}
+
+TEST_CASE("ObjectCache keeps objects constructed between uses", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    {
+        ObjectCache<Counted> cache;
+        REQUIRE(cache.init(&heap, "counted"));
+
+        auto* object = cache.allocate();
+        REQUIRE(object);
+        REQUIRE(object->value == 42);
+        REQUIRE(Counted::count == int(cache.getStats().objectsCount));
+
+        object->value = 7;
+        cache.release(object);
+        object = cache.allocate();
+        REQUIRE(object->value == 7);
+        cache.release(object);
+    }
+
+    REQUIRE(Counted::count == 0);
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+} // namespace memory
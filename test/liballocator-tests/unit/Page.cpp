@@ -55,6 +55,42 @@ TEST_CASE("Page is properly initialized", "[unit][Page]")
     REQUIRE(page->address() == 0);
     REQUIRE(page->groupSize() == 0);
     REQUIRE(!page->isUsed());
+    REQUIRE(!page->hasZoneHeader());
+    REQUIRE(!page->isPinned());
+}
+
+TEST_CASE("Page flags are independent", "[unit][Page]")
+{
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->init();
+
+    constexpr std::size_t cGroupSize = 17;
+    page->setGroupSize(cGroupSize);
+    page->setUsed(true);
+    page->setZoneHeader(true);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(page->isUsed());
+    REQUIRE(page->hasZoneHeader());
+
+    page->setUsed(false);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(!page->isUsed());
+    REQUIRE(page->hasZoneHeader());
+
+    page->setPinned(true);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(page->hasZoneHeader());
+    REQUIRE(page->isPinned());
+
+    page->setZoneHeader(false);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(!page->isUsed());
+    REQUIRE(!page->hasZoneHeader());
+    REQUIRE(page->isPinned());
+
+    page->setPinned(false);
+    REQUIRE(!page->isPinned());
 }
 
 TEST_CASE("Accessing siblings works as expected", "[unit][Page]")
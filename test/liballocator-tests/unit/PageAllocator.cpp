@@ -40,6 +40,7 @@
 #include <array>
 #include <cmath>
 #include <cstring>
+#include <random>
 #include <vector>
 
 namespace memory {
@@ -383,6 +384,12 @@ TEST_CASE("Pages are correctly resolved from address", "[unit][PageAllocator]")
         REQUIRE(page->address() == (std::uintptr_t(memory2.get()) + (cPagesCount2 - 1) * cPageSize));
     }
 
+    SECTION("Address points right after the end of the third region")
+    {
+        page = pageAllocator.getPage(std::uintptr_t(memory3.get()) + size3);
+        REQUIRE(page == nullptr);
+    }
+
     SECTION("Address points to the 16th page in the first region")
     {
         constexpr int cPageNum = 16;
@@ -414,6 +421,41 @@ TEST_CASE("Pages are correctly resolved from address", "[unit][PageAllocator]")
     }
 }
 
+TEST_CASE("Pages at the border of adjacent regions are resolved to their own region", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount1 = 32;
+    constexpr std::size_t cPagesCount2 = 16;
+    PageAllocator pageAllocator;
+
+    auto size1 = cPageSize * cPagesCount1;
+    auto size2 = cPageSize * cPagesCount2;
+    auto memory = test::alignedAlloc(cPageSize, size1 + size2);
+    auto start1 = std::uintptr_t(memory.get());
+    auto start2 = start1 + size1;
+
+    // Second region starts right at the end of the first one, so the end of the first region is not inside it.
+    constexpr int cRegionsCount = 3;
+    std::array<Region, cRegionsCount> regions = {
+        {{start1, size1, Tier::eNormal, Caps::eNone}, {start2, size2, Tier::eSlow, Caps::eDma}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    auto* lastPage = pageAllocator.getPage(start2 - 1);
+    REQUIRE(lastPage);
+    REQUIRE(lastPage->address() == start2 - cPageSize);
+    REQUIRE(pageAllocator.getTier(lastPage) == Tier::eNormal);
+    REQUIRE(pageAllocator.getCaps(lastPage) == Caps::eNone);
+
+    auto* firstPage = pageAllocator.getPage(start2);
+    REQUIRE(firstPage);
+    REQUIRE(firstPage->address() == start2);
+    REQUIRE(pageAllocator.getTier(firstPage) == Tier::eSlow);
+    REQUIRE(pageAllocator.getCaps(firstPage) == Caps::eDma);
+
+    REQUIRE(pageAllocator.getPage(start2 + size2) == nullptr);
+}
+
 TEST_CASE("PageAllocator stats are properly initialized", "[unit][PageAllocator]")
 {
     constexpr std::size_t cPageSize = 256;
@@ -760,4 +802,455 @@ TEST_CASE("Pages are correctly released", "[unit][PageAllocator]")
     REQUIRE(stats.freePagesCount == freePages);
 }
 
+TEST_CASE("Region stats are properly tracked", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    PageAllocator pageAllocator;
+
+    constexpr std::size_t cPagesCount1 = 535;
+    constexpr std::size_t cPagesCount2 = 87;
+    constexpr std::size_t cPagesCount3 = 4;
+    auto size1 = cPageSize * cPagesCount1;
+    auto size2 = cPageSize * cPagesCount2;
+    auto size3 = cPageSize * cPagesCount3;
+    auto memory1 = test::alignedAlloc(cPageSize, size1);
+    auto memory2 = test::alignedAlloc(cPageSize, size2);
+    auto memory3 = test::alignedAlloc(cPageSize, size3);
+
+    constexpr int cRegionsCount = 4;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory1.get()), size1},
+                                                  {std::uintptr_t(memory2.get()), size2},
+                                                  {std::uintptr_t(memory3.get()), size3},
+                                                  {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    std::array<allocator::RegionStats, allocator::cMaxRegionsCount> regionStats{};
+    REQUIRE(pageAllocator.getRegionStats(regionStats) == cRegionsCount - 1);
+
+    std::size_t freePagesCount = 0;
+    for (std::size_t i = 0; i < cRegionsCount - 1; ++i) {
+        const auto& stats = regionStats.at(i);
+        REQUIRE(stats.start == regions.at(i).address);
+        REQUIRE(stats.pagesCount == regions.at(i).size / cPageSize);
+        REQUIRE(stats.peakUsedPagesCount == stats.pagesCount - stats.freePagesCount);
+        REQUIRE(stats.largestFreeGroupSize == stats.freePagesCount);
+        freePagesCount += stats.freePagesCount;
+    }
+
+    REQUIRE(freePagesCount == pageAllocator.getStats().freePagesCount);
+    REQUIRE(regionStats[0].freePagesCount == cPagesCount1);
+    REQUIRE(regionStats[2].freePagesCount == cPagesCount3);
+
+    constexpr std::size_t cAllocatedCount1 = 100;
+    constexpr std::size_t cAllocatedCount2 = 10;
+    auto* pages1 = pageAllocator.allocate(cAllocatedCount1);
+    auto* pages2 = pageAllocator.allocate(cAllocatedCount2);
+    REQUIRE(pages1);
+    REQUIRE(pages2);
+    REQUIRE(pages1->address() == regions[0].address);
+
+    pageAllocator.getRegionStats(regionStats);
+    REQUIRE(regionStats[0].freePagesCount == cPagesCount1 - cAllocatedCount1 - cAllocatedCount2);
+    REQUIRE(regionStats[0].peakUsedPagesCount == cAllocatedCount1 + cAllocatedCount2);
+    REQUIRE(regionStats[0].largestFreeGroupSize == cPagesCount1 - cAllocatedCount1 - cAllocatedCount2);
+
+    pageAllocator.release(pages1);
+    pageAllocator.getRegionStats(regionStats);
+    REQUIRE(regionStats[0].freePagesCount == cPagesCount1 - cAllocatedCount2);
+    REQUIRE(regionStats[0].peakUsedPagesCount == cAllocatedCount1 + cAllocatedCount2);
+    REQUIRE(regionStats[0].largestFreeGroupSize == cPagesCount1 - cAllocatedCount1 - cAllocatedCount2);
+    REQUIRE(pageAllocator.largestFreeGroupSize() == cPagesCount1 - cAllocatedCount1 - cAllocatedCount2);
+
+    pageAllocator.release(pages2);
+    REQUIRE(pageAllocator.largestFreeGroupSize() == cPagesCount1);
+}
+
+TEST_CASE("Largest free group is tracked across allocations and releases", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 512;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    // Region stats walk all free groups, so they are the reference for the running maximum.
+    auto walkedLargestSize = [&pageAllocator]() {
+        std::array<allocator::RegionStats, allocator::cMaxRegionsCount> regionStats{};
+        pageAllocator.getRegionStats(regionStats);
+        return regionStats.at(0).largestFreeGroupSize;
+    };
+
+    constexpr std::size_t cMaxGroupSize = 64;
+    std::mt19937 randomGenerator(cPagesCount);
+    std::uniform_int_distribution<std::size_t> sizeDistribution(1, cMaxGroupSize);
+    std::vector<Page*> allocated;
+    for (std::size_t i = 0; i < 4 * cPagesCount; ++i) {
+        if (allocated.empty() || randomGenerator() % 3 != 0) {
+            if (auto* pages = pageAllocator.allocate(sizeDistribution(randomGenerator)))
+                allocated.push_back(pages);
+        }
+        else {
+            auto idx = randomGenerator() % allocated.size();
+            pageAllocator.release(allocated.at(idx));
+            allocated.erase(allocated.begin() + std::ptrdiff_t(idx));
+        }
+
+        REQUIRE(pageAllocator.largestFreeGroupSize() == walkedLargestSize());
+    }
+
+    for (auto* pages : allocated)
+        pageAllocator.release(pages);
+
+    REQUIRE(pageAllocator.largestFreeGroupSize() == walkedLargestSize());
+}
+
+TEST_CASE("Pages are allocated as separate groups", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+    auto largestFreeGroupSize = pageAllocator.largestFreeGroupSize();
+
+    REQUIRE(pageAllocator.allocateSeparate(0) == nullptr);
+    REQUIRE(pageAllocator.allocateSeparate(freePagesCount + 1) == nullptr);
+
+    constexpr std::size_t cSeparateCount = 8;
+    auto* pages = pageAllocator.allocateSeparate(cSeparateCount);
+    REQUIRE(pages);
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cSeparateCount);
+
+    std::vector<Page*> separatePages;
+    for (std::size_t i = 0; i < cSeparateCount; ++i) {
+        auto* page = pageAllocator.getPage(pages->address() + i * cPageSize);
+        REQUIRE(page);
+        REQUIRE(page->isUsed());
+        REQUIRE(page->groupSize() == 1);
+        separatePages.push_back(page);
+    }
+
+    // Every other page is released first, so no released page can join its neighbours.
+    for (std::size_t i = 0; i < cSeparateCount; i += 2)
+        pageAllocator.release(separatePages.at(i));
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cSeparateCount / 2);
+    for (std::size_t i = 1; i < cSeparateCount; i += 2)
+        REQUIRE(separatePages.at(i)->isUsed());
+
+    for (std::size_t i = 1; i < cSeparateCount; i += 2)
+        pageAllocator.release(separatePages.at(i));
+
+    // Released pages wait in the quick lists, until a group bigger than any free group is demanded.
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    REQUIRE(pageAllocator.largestFreeGroupSize() == largestFreeGroupSize - cSeparateCount);
+
+    auto* group = pageAllocator.allocate(largestFreeGroupSize);
+    REQUIRE(group);
+    pageAllocator.release(group);
+    REQUIRE(pageAllocator.largestFreeGroupSize() == largestFreeGroupSize);
+}
+
+TEST_CASE("Small groups are reused from the quick lists before coalescing", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 128;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    SECTION("Released group is taken again without splitting")
+    {
+        constexpr std::size_t cGroupSize = 2;
+        auto* pages1 = pageAllocator.allocate(cGroupSize);
+        auto* pages2 = pageAllocator.allocate(cGroupSize);
+        REQUIRE(pages1);
+        REQUIRE(pages2);
+
+        // Released group is counted as free, but it is not joined with the free pages following it.
+        pageAllocator.release(pages2);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cGroupSize);
+        REQUIRE(pages2->isUsed());
+        REQUIRE(pages2->groupSize() == cGroupSize);
+
+        REQUIRE(pageAllocator.allocate(cGroupSize) == pages2);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - 2 * cGroupSize);
+
+        // Querying the statistics counts the released groups as they are, without joining them.
+        pageAllocator.release(pages1);
+        pageAllocator.release(pages2);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+        REQUIRE(pageAllocator.largestFreeGroupSize() == freePagesCount - 2 * cGroupSize);
+
+        std::array<allocator::RegionStats, allocator::cMaxRegionsCount> regionStats{};
+        pageAllocator.getRegionStats(regionStats);
+        REQUIRE(regionStats.at(0).largestFreeGroupSize == freePagesCount - 2 * cGroupSize);
+        REQUIRE(pages1->isUsed());
+        REQUIRE(pages2->isUsed());
+    }
+
+    SECTION("Quick lists are coalesced when a bigger group is demanded")
+    {
+        std::vector<Page*> pages;
+        while (auto* page = pageAllocator.allocate(1))
+            pages.push_back(page);
+
+        REQUIRE(pages.size() == freePagesCount);
+        REQUIRE(pageAllocator.getStats().freePagesCount == 0);
+
+        for (auto* page : pages)
+            pageAllocator.release(page);
+
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+
+        auto* group = pageAllocator.allocate(freePagesCount);
+        REQUIRE(group);
+        REQUIRE(group->groupSize() == freePagesCount);
+
+        pageAllocator.release(group);
+        REQUIRE(pageAllocator.largestFreeGroupSize() == freePagesCount);
+    }
+}
+
+TEST_CASE("Pages are allocated from the requested tier with fallback", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    PageAllocator pageAllocator;
+
+    constexpr std::size_t cFastPagesCount = 16;
+    constexpr std::size_t cNormalPagesCount = 256;
+    constexpr std::size_t cSlowPagesCount = 64;
+    auto fastSize = cPageSize * cFastPagesCount;
+    auto normalSize = cPageSize * cNormalPagesCount;
+    auto slowSize = cPageSize * cSlowPagesCount;
+    auto fastMemory = test::alignedAlloc(cPageSize, fastSize);
+    auto normalMemory = test::alignedAlloc(cPageSize, normalSize);
+    auto slowMemory = test::alignedAlloc(cPageSize, slowSize);
+
+    constexpr int cRegionsCount = 4;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(slowMemory.get()), slowSize, Tier::eSlow},
+                                                  {std::uintptr_t(normalMemory.get()), normalSize, Tier::eNormal},
+                                                  {std::uintptr_t(fastMemory.get()), fastSize, Tier::eFast},
+                                                  {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    auto tierOf = [&](Page* page) {
+        for (const auto& region : regions) {
+            if (page->address() >= region.address && page->address() < region.address + region.size)
+                return region.tier;
+        }
+
+        FAIL("Page is outside of all regions");
+        return Tier::eNormal;
+    };
+
+    std::array<allocator::TierStats, cTiersCount> tierStats{};
+    pageAllocator.getTierStats(tierStats);
+    REQUIRE(tierStats.at(std::size_t(Tier::eFast)).pagesCount == cFastPagesCount);
+    REQUIRE(tierStats.at(std::size_t(Tier::eNormal)).pagesCount == cNormalPagesCount);
+    REQUIRE(tierStats.at(std::size_t(Tier::eSlow)).pagesCount == cSlowPagesCount);
+
+    std::size_t freePagesCount = 0;
+    for (const auto& stats : tierStats) {
+        REQUIRE(stats.requestsCount == 0);
+        REQUIRE(stats.fallbacksCount == 0);
+        freePagesCount += stats.freePagesCount;
+    }
+
+    REQUIRE(freePagesCount == pageAllocator.getStats().freePagesCount);
+
+    auto fastFreeCount = tierStats.at(std::size_t(Tier::eFast)).freePagesCount;
+    auto normalFreeCount = tierStats.at(std::size_t(Tier::eNormal)).freePagesCount;
+    auto slowFreeCount = tierStats.at(std::size_t(Tier::eSlow)).freePagesCount;
+    REQUIRE(fastFreeCount != 0);
+    REQUIRE(normalFreeCount != 0);
+    REQUIRE(slowFreeCount != 0);
+
+    SECTION("Pages are allocated from the normal tier by default")
+    {
+        auto* pages = pageAllocator.allocate(1);
+        REQUIRE(pages);
+        REQUIRE(tierOf(pages) == Tier::eNormal);
+    }
+
+    SECTION("Exhausted tier overflows to slower tiers first")
+    {
+        auto* fastPages = pageAllocator.allocate(fastFreeCount, Tier::eFast);
+        REQUIRE(fastPages);
+        REQUIRE(tierOf(fastPages) == Tier::eFast);
+
+        auto* overflowPages = pageAllocator.allocate(1, Tier::eFast);
+        REQUIRE(overflowPages);
+        REQUIRE(tierOf(overflowPages) == Tier::eNormal);
+
+        auto* normalPages = pageAllocator.allocate(normalFreeCount - 1, Tier::eNormal);
+        REQUIRE(normalPages);
+        REQUIRE(tierOf(normalPages) == Tier::eNormal);
+
+        overflowPages = pageAllocator.allocate(1, Tier::eFast);
+        REQUIRE(overflowPages);
+        REQUIRE(tierOf(overflowPages) == Tier::eSlow);
+
+        pageAllocator.getTierStats(tierStats);
+        REQUIRE(tierStats.at(std::size_t(Tier::eFast)).requestsCount == 3);
+        REQUIRE(tierStats.at(std::size_t(Tier::eFast)).fallbacksCount == 2);
+        REQUIRE(tierStats.at(std::size_t(Tier::eFast)).freePagesCount == 0);
+        REQUIRE(tierStats.at(std::size_t(Tier::eFast)).servedPagesCount == fastFreeCount);
+        REQUIRE(tierStats.at(std::size_t(Tier::eNormal)).requestsCount == 1);
+        REQUIRE(tierStats.at(std::size_t(Tier::eNormal)).fallbacksCount == 0);
+        REQUIRE(tierStats.at(std::size_t(Tier::eNormal)).servedPagesCount == normalFreeCount);
+        REQUIRE(tierStats.at(std::size_t(Tier::eSlow)).servedPagesCount == 1);
+    }
+
+    SECTION("Exhausted slowest tier overflows to the nearest faster tier")
+    {
+        auto* slowPages = pageAllocator.allocate(slowFreeCount, Tier::eSlow);
+        REQUIRE(slowPages);
+        REQUIRE(tierOf(slowPages) == Tier::eSlow);
+
+        auto* overflowPages = pageAllocator.allocate(1, Tier::eSlow);
+        REQUIRE(overflowPages);
+        REQUIRE(tierOf(overflowPages) == Tier::eNormal);
+
+        pageAllocator.release(overflowPages);
+        auto* normalPages = pageAllocator.allocate(normalFreeCount, Tier::eNormal);
+        REQUIRE(normalPages);
+
+        overflowPages = pageAllocator.allocate(1, Tier::eSlow);
+        REQUIRE(overflowPages);
+        REQUIRE(tierOf(overflowPages) == Tier::eFast);
+
+        pageAllocator.getTierStats(tierStats);
+        REQUIRE(tierStats.at(std::size_t(Tier::eSlow)).requestsCount == 3);
+        REQUIRE(tierStats.at(std::size_t(Tier::eSlow)).fallbacksCount == 2);
+    }
+
+    SECTION("Allocation fails only if no tier has a group big enough")
+    {
+        REQUIRE(pageAllocator.allocate(normalFreeCount + 1, Tier::eFast) == nullptr);
+        REQUIRE(pageAllocator.largestFreeGroupSize() == normalFreeCount);
+
+        auto* pages = pageAllocator.allocate(normalFreeCount, Tier::eFast);
+        REQUIRE(pages);
+        REQUIRE(tierOf(pages) == Tier::eNormal);
+
+        pageAllocator.release(pages);
+        pageAllocator.getTierStats(tierStats);
+        REQUIRE(tierStats.at(std::size_t(Tier::eNormal)).freePagesCount == normalFreeCount);
+    }
+}
+
+TEST_CASE("Pages are allocated with demanded capabilities and within boundaries", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    PageAllocator pageAllocator;
+
+    constexpr std::size_t cPlainPagesCount = 128;
+    constexpr std::size_t cDmaPagesCount = 64;
+    constexpr std::size_t cUncachedPagesCount = 32;
+    auto plainSize = cPageSize * cPlainPagesCount;
+    auto dmaSize = cPageSize * cDmaPagesCount;
+    auto uncachedSize = cPageSize * cUncachedPagesCount;
+    auto plainMemory = test::alignedAlloc(cPageSize, plainSize);
+    auto dmaMemory = test::alignedAlloc(cPageSize, dmaSize);
+    auto uncachedMemory = test::alignedAlloc(cPageSize, uncachedSize);
+
+    constexpr auto cUncachedCaps = Caps::eDma | Caps::eNonCacheable;
+    constexpr int cRegionsCount = 4;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(plainMemory.get()), plainSize},
+         {std::uintptr_t(dmaMemory.get()), dmaSize, Tier::eNormal, Caps::eDma},
+         {std::uintptr_t(uncachedMemory.get()), uncachedSize, Tier::eNormal, cUncachedCaps},
+         {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    std::array<allocator::RegionStats, allocator::cMaxRegionsCount> regionStats{};
+    REQUIRE(pageAllocator.getRegionStats(regionStats) == cRegionsCount - 1);
+    REQUIRE(regionStats[0].caps == Caps::eNone);
+    REQUIRE(regionStats[1].caps == Caps::eDma);
+    REQUIRE(regionStats[2].caps == cUncachedCaps);
+    REQUIRE(regionStats[1].freePagesCount == cDmaPagesCount);
+    REQUIRE(regionStats[2].freePagesCount == cUncachedPagesCount);
+
+    SECTION("Pages come only from regions with all demanded capabilities")
+    {
+        std::vector<Page*> allocatedPages;
+        for (std::size_t i = 0; i < regionStats[1].freePagesCount + regionStats[2].freePagesCount; ++i) {
+            auto* pages = pageAllocator.allocate(1, Tier::eNormal, Caps::eDma);
+            REQUIRE(pages);
+            REQUIRE(hasCaps(pageAllocator.getCaps(pages), Caps::eDma));
+            allocatedPages.push_back(pages);
+        }
+
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eDma) == nullptr);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eNone));
+
+        for (auto* pages : allocatedPages)
+            pageAllocator.release(pages);
+
+        auto* pages = pageAllocator.allocate(regionStats[2].freePagesCount, Tier::eNormal, cUncachedCaps);
+        REQUIRE(pages);
+        REQUIRE(pageAllocator.getCaps(pages) == cUncachedCaps);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eNonCacheable) == nullptr);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eDma));
+    }
+
+    SECTION("Allocated pages never cross the demanded boundary")
+    {
+        constexpr std::array<std::size_t, 2> cBoundaries = {1024, 4096};
+        for (auto boundary : cBoundaries) {
+            for (std::size_t count = 1; count * cPageSize <= boundary; ++count) {
+                std::vector<Page*> allocatedPages;
+                while (auto* pages = pageAllocator.allocate(count, Tier::eNormal, Caps::eNone, boundary)) {
+                    auto start = pages->address();
+                    auto end = start + count * cPageSize - 1;
+                    REQUIRE(pages->groupSize() == count);
+                    REQUIRE(start / boundary == end / boundary);
+                    allocatedPages.push_back(pages);
+                }
+
+                REQUIRE(!allocatedPages.empty());
+                for (auto* pages : allocatedPages)
+                    pageAllocator.release(pages);
+
+                REQUIRE(pageAllocator.getStats().freePagesCount
+                        == regionStats[0].freePagesCount + regionStats[1].freePagesCount
+                               + regionStats[2].freePagesCount);
+            }
+        }
+    }
+
+    SECTION("Invalid boundaries are rejected")
+    {
+        constexpr std::size_t cBoundary = 1024;
+        REQUIRE(pageAllocator.allocate(cBoundary / cPageSize + 1, Tier::eNormal, Caps::eNone, cBoundary) == nullptr);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eNone, cPageSize / 2) == nullptr);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eNone, cBoundary + cPageSize) == nullptr);
+        REQUIRE(pageAllocator.allocate(1, Tier::eNormal, Caps::eNone, cPageSize));
+    }
+}
+
 } // namespace memory
@@ -0,0 +1,139 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/StlAllocator.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("StlAllocator allocates containers from the heap", "[unit][StlAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto start = std::uintptr_t(memory.get());
+
+    Heap heap;
+    REQUIRE(heap.init(start, start + size, cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    StlAllocator<std::uint64_t> allocator(&heap);
+    StlAllocator<char> otherAllocator(allocator);
+    Heap otherHeap;
+    REQUIRE(allocator.source() == &heap);
+    REQUIRE(allocator == otherAllocator);
+    REQUIRE(allocator != StlAllocator<std::uint64_t>(&otherHeap));
+
+    SECTION("Single objects and arrays are allocated from the heap")
+    {
+        auto* object = allocator.allocate(1);
+        REQUIRE(object);
+        REQUIRE(std::uintptr_t(object) >= start);
+        REQUIRE(std::uintptr_t(object) < start + size);
+        REQUIRE(std::uintptr_t(object) % alignof(std::uint64_t) == 0);
+
+        constexpr std::size_t cCount = 100;
+        auto* array = allocator.allocate(cCount);
+        REQUIRE(array);
+        REQUIRE(std::uintptr_t(array) >= start);
+        REQUIRE(std::uintptr_t(array) + cCount * sizeof(std::uint64_t) <= start + size);
+
+        allocator.deallocate(object, 1);
+        allocator.deallocate(array, cCount);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+
+    SECTION("Node based containers allocate their nodes from the heap")
+    {
+        using Allocator = StlAllocator<std::pair<const int, int>>;
+        {
+            std::map<int, int, std::less<>, Allocator> values{Allocator(&heap)};
+            constexpr int cValuesCount = 50;
+            for (int i = 0; i < cValuesCount; ++i)
+                values.emplace(i, -i);
+
+            REQUIRE(heap.getStats().allocatedMemorySize != 0);
+            for (int i = 0; i < cValuesCount; ++i)
+                REQUIRE(values.at(i) == -i);
+
+            std::list<int, StlAllocator<int>> list{StlAllocator<int>(&heap)};
+            list.assign(cValuesCount, 1);
+            REQUIRE(list.size() == cValuesCount);
+        }
+
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+}
+
+TEST_CASE("StlAllocator allocates containers from the arena", "[unit][StlAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    Arena arena;
+    REQUIRE(arena.init(&heap, cPageSize));
+
+    {
+        using Allocator = StlAllocator<std::uint32_t, Arena>;
+        std::vector<std::uint32_t, Allocator> values{Allocator(&arena)};
+        constexpr std::size_t cValuesCount = 100;
+        for (std::size_t i = 0; i < cValuesCount; ++i)
+            values.push_back(std::uint32_t(i));
+
+        REQUIRE(arena.blocksCount() > 1);
+        for (std::size_t i = 0; i < cValuesCount; ++i)
+            REQUIRE(values.at(i) == i);
+    }
+
+    REQUIRE(arena.blocksCount() != 0);
+    arena.reset();
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+} // namespace memory
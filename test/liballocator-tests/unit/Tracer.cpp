@@ -0,0 +1,269 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2021, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/Tracer.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace memory {
+namespace {
+
+std::uint64_t testClock()
+{
+    static std::uint64_t time = 0;
+    return ++time;
+}
+
+std::uint16_t testThreadId()
+{
+    constexpr std::uint16_t cThreadId = 7;
+    return cThreadId;
+}
+
+/// Parses the given binary trace into the header and events.
+void parseTrace(const std::vector<std::byte>& trace, TraceHeader& header, std::vector<TraceEvent>& events)
+{
+    REQUIRE(trace.size() >= sizeof(TraceHeader));
+    std::memcpy(&header, trace.data(), sizeof(header));
+    REQUIRE(trace.size() == sizeof(TraceHeader) + header.eventsCount * sizeof(TraceEvent));
+
+    events.resize(header.eventsCount);
+    std::memcpy(events.data(), trace.data() + sizeof(TraceHeader), header.eventsCount * sizeof(TraceEvent));
+}
+
+} // namespace
+
+TEST_CASE("Tracer is properly initialized", "[unit][Tracer]")
+{
+    constexpr std::size_t cCapacity = 16;
+    std::array<TraceSlot, cCapacity> slots{};
+    Tracer tracer;
+
+    SECTION("Capacity is a power of 2")
+    {
+        REQUIRE(tracer.init(slots.data(), cCapacity));
+        REQUIRE(tracer.recordedCount() == 0);
+        REQUIRE(tracer.exportSize() == sizeof(TraceHeader));
+    }
+
+    SECTION("Capacity is not a power of 2")
+    {
+        REQUIRE(!tracer.init(slots.data(), cCapacity - 1));
+    }
+
+    SECTION("Storage is missing")
+    {
+        REQUIRE(!tracer.init(nullptr, cCapacity));
+    }
+
+    SECTION("Not initialized tracer ignores events")
+    {
+        tracer.record(TraceEventType::eAllocate, slots.data(), 1);
+        REQUIRE(tracer.recordedCount() == 0);
+    }
+}
+
+TEST_CASE("Tracer records and exports events", "[unit][Tracer]")
+{
+    constexpr std::size_t cCapacity = 8;
+    std::array<TraceSlot, cCapacity> slots{};
+    Tracer tracer;
+    REQUIRE(tracer.init(slots.data(), cCapacity, testClock, testThreadId));
+
+    std::size_t eventsCount = 0;
+    SECTION("Buffer is not full")
+    {
+        eventsCount = cCapacity / 2;
+    }
+
+    SECTION("Buffer has wrapped")
+    {
+        eventsCount = 3 * cCapacity + 3;
+    }
+
+    for (std::size_t i = 0; i < eventsCount; ++i) {
+        auto type = (i % 2 == 0) ? TraceEventType::eAllocate : TraceEventType::eRelease;
+        tracer.record(type, reinterpret_cast<void*>(i + 1), i); // NOLINT(performance-no-int-to-ptr)
+    }
+
+    REQUIRE(tracer.recordedCount() == eventsCount);
+
+    std::vector<std::byte> trace(tracer.exportSize());
+    REQUIRE(tracer.exportTrace(trace.data(), trace.size() - 1) == 0);
+    REQUIRE(tracer.exportTrace(trace.data(), trace.size()) == trace.size());
+
+    TraceHeader header{};
+    std::vector<TraceEvent> exported;
+    parseTrace(trace, header, exported);
+
+    auto expectedCount = std::min(eventsCount, cCapacity);
+    REQUIRE(std::string(header.magic.data(), header.magic.size()) == "LATR");
+    REQUIRE(header.version == 1);
+    REQUIRE(header.eventSize == sizeof(TraceEvent));
+    REQUIRE(header.eventsCount == expectedCount);
+    REQUIRE(header.droppedCount == eventsCount - expectedCount);
+
+    auto first = eventsCount - expectedCount;
+    for (std::size_t i = 0; i < exported.size(); ++i) {
+        const auto& event = exported.at(i);
+        REQUIRE(event.address == first + i + 1);
+        REQUIRE(event.size == first + i);
+        REQUIRE(event.type == (((first + i) % 2 == 0) ? TraceEventType::eAllocate : TraceEventType::eRelease));
+        REQUIRE(event.threadId == testThreadId());
+        if (i > 0)
+            REQUIRE(event.timestamp > exported.at(i - 1).timestamp);
+    }
+}
+
+TEST_CASE("Tracer drops events, that would tear an event being written", "[unit][Tracer]")
+{
+    constexpr std::size_t cCapacity = 4;
+    std::array<TraceSlot, cCapacity> slots{};
+    Tracer tracer;
+
+    // Storage reused from another tracer still holds old sequence numbers, that must not block the new events.
+    slots.at(0).sequence = 1000;
+    REQUIRE(tracer.init(slots.data(), cCapacity));
+
+    for (std::size_t i = 0; i < cCapacity; ++i)
+        tracer.record(TraceEventType::eAllocate, &slots.at(i), i);
+
+    // Writer of the second event is still busy, when the buffer wraps around to its slot.
+    constexpr std::size_t cBusyIdx = 1;
+    auto sequence = slots.at(cBusyIdx).sequence.load();
+    slots.at(cBusyIdx).sequence = sequence - 1;
+
+    for (std::size_t i = 0; i < cCapacity; ++i)
+        tracer.record(TraceEventType::eRelease, &slots.at(i), 0);
+
+    REQUIRE(tracer.recordedCount() == 2 * cCapacity);
+
+    std::vector<std::byte> trace(tracer.exportSize());
+    REQUIRE(tracer.exportTrace(trace.data(), trace.size()) == trace.size() - sizeof(TraceEvent));
+    trace.resize(trace.size() - sizeof(TraceEvent));
+
+    TraceHeader header{};
+    std::vector<TraceEvent> exported;
+    parseTrace(trace, header, exported);
+
+    REQUIRE(header.eventsCount == cCapacity - 1);
+    REQUIRE(header.droppedCount == cCapacity + 1);
+    for (const auto& event : exported) {
+        REQUIRE(event.type == TraceEventType::eRelease);
+        REQUIRE(event.address != std::uintptr_t(&slots.at(cBusyIdx)));
+    }
+
+    // Once the older writer finishes, the slot is taken by the following events again.
+    slots.at(cBusyIdx).sequence = sequence;
+    for (std::size_t i = 0; i < cCapacity; ++i)
+        tracer.record(TraceEventType::eAllocate, &slots.at(i), 1);
+
+    trace.resize(tracer.exportSize());
+    REQUIRE(tracer.exportTrace(trace.data(), trace.size()) == trace.size());
+}
+
+TEST_CASE("Tracer saturates sizes, that don't fit in the event", "[unit][Tracer]")
+{
+    constexpr std::size_t cCapacity = 2;
+    std::array<TraceSlot, cCapacity> slots{};
+    Tracer tracer;
+    REQUIRE(tracer.init(slots.data(), cCapacity));
+
+    auto maxSize = std::size_t(std::numeric_limits<std::uint32_t>::max());
+    tracer.record(TraceEventType::eAllocate, slots.data(), maxSize);
+    tracer.record(TraceEventType::eAllocate, slots.data(), std::numeric_limits<std::size_t>::max());
+
+    REQUIRE(slots.at(0).event.size == maxSize);
+    REQUIRE(slots.at(1).event.size == maxSize);
+}
+
+TEST_CASE("Heap records its events in the tracer", "[unit][Tracer]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 16;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr std::size_t cCapacity = 16;
+    std::array<TraceSlot, cCapacity> slots{};
+    Tracer tracer;
+    REQUIRE(tracer.init(slots.data(), cCapacity));
+
+    Heap heap;
+    heap.setTracer(&tracer);
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr std::size_t cAllocSize = 40;
+    auto* ptr1 = heap.allocate(cAllocSize);
+    auto* ptr2 = heap.tryReserve(cPageSize);
+    REQUIRE(ptr1);
+    REQUIRE(ptr2);
+    REQUIRE(heap.allocate(size) == nullptr);
+    heap.release(ptr1);
+    heap.release(nullptr);
+    heap.release(ptr2);
+
+    heap.setTracer(nullptr);
+    REQUIRE(heap.allocate(cAllocSize));
+
+    std::vector<std::byte> trace(tracer.exportSize());
+    REQUIRE(tracer.exportTrace(trace.data(), trace.size()) == trace.size());
+
+    TraceHeader header{};
+    std::vector<TraceEvent> exported;
+    parseTrace(trace, header, exported);
+
+    REQUIRE(exported.size() == 4);
+    REQUIRE(exported[0].type == TraceEventType::eAllocate);
+    REQUIRE(exported[0].address == std::uintptr_t(ptr1));
+    REQUIRE(exported[0].size == cAllocSize);
+    REQUIRE(exported[1].type == TraceEventType::eAllocate);
+    REQUIRE(exported[1].address == std::uintptr_t(ptr2));
+    REQUIRE(exported[1].size == cPageSize);
+    REQUIRE(exported[2].type == TraceEventType::eRelease);
+    REQUIRE(exported[2].address == std::uintptr_t(ptr1));
+    REQUIRE(exported[3].type == TraceEventType::eRelease);
+    REQUIRE(exported[3].address == std::uintptr_t(ptr2));
+}
+
+} // namespace memory
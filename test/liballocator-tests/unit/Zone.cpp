@@ -33,11 +33,13 @@
 #include <Page.hpp>
 #include <TestUtils.hpp>
 #include <Zone.hpp>
+#include <utils.hpp>
 
 #include <catch2/catch.hpp>
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 namespace memory {
 
@@ -71,13 +73,90 @@ TEST_CASE("Zone is properly initialized", "[unit][Zone]")
     REQUIRE(zone.chunksCount() == (cPageSize / cChunkSize));
     REQUIRE(zone.freeChunksCount() == (cPageSize / cChunkSize));
 
-    auto* chunk = reinterpret_cast<Chunk*>(zone.page()->address());
     for (std::size_t i = 0; i < zone.chunksCount(); ++i) {
+        auto* chunk = zone.takeChunk();
         REQUIRE(std::uintptr_t(chunk) == zone.page()->address() + i * cChunkSize);
-        chunk = chunk->prev();
     }
 }
 
+TEST_CASE("Zone initialization does not touch the chunks", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::byte cPattern{0xa5};
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+    std::memset(memory.get(), int(cPattern), cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 16;
+    zone.init(page, cPageSize, cChunkSize);
+
+    auto* bytes = reinterpret_cast<std::byte*>(memory.get());
+    for (std::size_t i = 0; i < cPageSize; ++i)
+        REQUIRE(bytes[i] == cPattern); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+TEST_CASE("Zone reuses released chunks before carving new ones", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 32;
+    zone.init(page, cPageSize, cChunkSize);
+
+    auto* chunk0 = zone.takeChunk();
+    auto* chunk1 = zone.takeChunk();
+    auto* chunk2 = zone.takeChunk();
+    REQUIRE(std::uintptr_t(chunk1) == std::uintptr_t(chunk0) + cChunkSize);
+    REQUIRE(std::uintptr_t(chunk2) == std::uintptr_t(chunk1) + cChunkSize);
+
+    zone.giveChunk(chunk0);
+    zone.giveChunk(chunk1);
+    REQUIRE(zone.freeChunksCount() == zone.chunksCount() - 1);
+    REQUIRE(zone.takeChunk() == chunk1);
+    REQUIRE(zone.takeChunk() == chunk0);
+    REQUIRE(std::uintptr_t(zone.takeChunk()) == std::uintptr_t(chunk2) + cChunkSize);
+    REQUIRE(zone.freeChunksCount() == zone.chunksCount() - 4);
+}
+
+TEST_CASE("Zone is properly initialized with offset", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 16;
+    constexpr std::size_t cOffset = 64;
+
+    zone.init(page, cPageSize, cChunkSize, cOffset);
+    REQUIRE(zone.page() == page);
+    REQUIRE(zone.chunkSize() == cChunkSize);
+    REQUIRE(zone.chunksCount() == ((cPageSize - cOffset) / cChunkSize));
+    REQUIRE(zone.freeChunksCount() == ((cPageSize - cOffset) / cChunkSize));
+
+    for (std::size_t i = 0; i < zone.chunksCount(); ++i) {
+        auto* chunk = zone.takeChunk();
+        REQUIRE(std::uintptr_t(chunk) >= zone.page()->address() + cOffset);
+        REQUIRE(std::uintptr_t(chunk) < zone.page()->address() + cPageSize);
+        REQUIRE(zone.isValidChunk(chunk));
+    }
+
+    REQUIRE(!zone.isValidChunk(reinterpret_cast<Chunk*>(zone.page()->address())));
+    REQUIRE(!zone.isValidChunk(reinterpret_cast<Chunk*>(zone.page()->address() + cOffset - cChunkSize)));
+}
+
 TEST_CASE("Zone is properly cleared", "[unit][Zone]")
 {
     Zone zone;
@@ -115,7 +194,7 @@ TEST_CASE("Zone properly allocates chunks", "[unit][Zone]")
         --freeChunksCount;
         auto* chunk = zone.takeChunk();
         REQUIRE(chunk);
-        REQUIRE(std::uintptr_t(chunk) == zone.page()->address() + cPageSize - cChunkSize * (1 + i));
+        REQUIRE(std::uintptr_t(chunk) == zone.page()->address() + cChunkSize * i);
         REQUIRE(zone.chunksCount() == chunksCount);
         REQUIRE(zone.freeChunksCount() == freeChunksCount);
     }
@@ -165,6 +244,38 @@ TEST_CASE("Zone properly deallocates chunks", "[unit][Zone]")
     REQUIRE(zone.freeChunksCount() == (cPageSize / cChunkSize));
 }
 
+TEST_CASE("Zone reuses released chunks of the minimal size in LIFO order", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 8;
+    zone.init(page, cPageSize, cChunkSize);
+    REQUIRE(zone.chunksCount() == cPageSize / cChunkSize);
+
+    std::array<Chunk*, (cPageSize / cChunkSize)> chunks{};
+    for (std::size_t i = 0; i < zone.chunksCount(); ++i) {
+        chunks.at(i) = zone.takeChunk();
+        REQUIRE(chunks.at(i) == utils::movePtr(chunks.at(0), i * cChunkSize));
+        std::memset(chunks.at(i), 0xff, cChunkSize);
+    }
+
+    zone.giveChunk(chunks[5]);
+    zone.giveChunk(chunks[1]);
+    zone.giveChunk(chunks[7]);
+    REQUIRE(zone.freeChunksCount() == 3);
+
+    REQUIRE(zone.takeChunk() == chunks[7]);
+    REQUIRE(zone.takeChunk() == chunks[1]);
+    REQUIRE(zone.takeChunk() == chunks[5]);
+    REQUIRE(zone.freeChunksCount() == 0);
+}
+
 TEST_CASE("Zone properly checks if given zone is valid", "[unit][Zone]")
 {
     constexpr std::size_t cPageSize = 256;
@@ -35,13 +35,16 @@
 #include <TestUtils.hpp>
 #include <ZoneAllocator.hpp>
 #include <allocator/Region.hpp>
+#include <utils.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstring>
 #include <map>
+#include <vector>
 
 namespace memory {
 
@@ -98,6 +101,13 @@ TEST_CASE("ZoneAllocator is properly initialized", "[unit][ZoneAllocator]")
         REQUIRE(stats.freeMemorySize == 0);
         REQUIRE(stats.allocatedMemorySize == 0);
     }
+
+    SECTION("Page size exceeds the zone capacity")
+    {
+        // Largest power of 2 page size, that still fits in the 16-bit chunk counters, is 256 KiB.
+        constexpr std::size_t cTooBigPageSize = ZoneAllocator::minimalAllocSize() * (Zone::maxChunksCount() + 1);
+        REQUIRE(!zoneAllocator.init(&pageAllocator, cTooBigPageSize));
+    }
 }
 
 TEST_CASE("ZoneAllocator stats are properly initialized", "[unit][ZoneAllocator]")
@@ -156,14 +166,15 @@ TEST_CASE("Chunk size is properly calculated", "[unit][ZoneAllocator]")
 
 TEST_CASE("Zone index is properly calculated", "[unit][ZoneAllocator]")
 {
-    std::map<std::size_t, std::pair<std::size_t, size_t>> idxRange = {{0, {16, 31}},      // NOLINT
-                                                                      {1, {32, 63}},      // NOLINT
-                                                                      {2, {64, 127}},     // NOLINT
-                                                                      {3, {128, 255}},    // NOLINT
-                                                                      {4, {256, 511}},    // NOLINT
-                                                                      {5, {512, 1023}},   // NOLINT
-                                                                      {6, {1024, 2047}},  // NOLINT
-                                                                      {7, {2048, 4095}}}; // NOLINT
+    std::map<std::size_t, std::pair<std::size_t, size_t>> idxRange = {{0, {8, 15}},       // NOLINT
+                                                                      {1, {16, 31}},      // NOLINT
+                                                                      {2, {32, 63}},      // NOLINT
+                                                                      {3, {64, 127}},     // NOLINT
+                                                                      {4, {128, 255}},    // NOLINT
+                                                                      {5, {256, 511}},    // NOLINT
+                                                                      {6, {512, 1023}},   // NOLINT
+                                                                      {7, {1024, 2047}},  // NOLINT
+                                                                      {8, {2048, 4095}}}; // NOLINT
 
     for (std::size_t i = idxRange[0].first; i < idxRange[idxRange.size() - 1].second; ++i) {
         auto idx = detail::zoneIdx(i);
@@ -322,6 +333,606 @@ TEST_CASE("Zone allocator properly allocates user memory", "[unit][ZoneAllocator
     }
 }
 
+TEST_CASE("Zone allocator serves sizes above the largest size class with pages", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 16384;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+    auto usedMemorySize = zoneAllocator.getStats().usedMemorySize;
+
+    constexpr std::size_t cAllocSizes[] = {4096, 8192, 8193};
+    for (auto allocSize : cAllocSizes) {
+        auto* ptr = zoneAllocator.allocate(allocSize);
+        REQUIRE(ptr);
+        REQUIRE(std::uintptr_t(ptr) % cPageSize == 0);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - 1);
+        REQUIRE(zoneAllocator.getStats().usedMemorySize == usedMemorySize);
+
+        zoneAllocator.release(ptr);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    }
+}
+
+TEST_CASE("Zone allocator stores small zone headers on-page", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    SECTION("Allocate 16 bytes")
+    {
+        constexpr std::size_t cAllocSize = 16;
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+
+        auto* page = pageAllocator.getPage(std::uintptr_t(ptr));
+        REQUIRE(page);
+        REQUIRE(page->hasZoneHeader());
+        REQUIRE(std::uintptr_t(ptr) >= page->address() + sizeof(Zone));
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - 1);
+
+        auto stats = zoneAllocator.getStats();
+        REQUIRE(stats.usedMemorySize == 2 * cPageSize);
+        REQUIRE(stats.reservedMemorySize == utils::alignUp(sizeof(Zone), detail::chunkSize(cAllocSize)));
+        REQUIRE(stats.allocatedMemorySize == detail::chunkSize(cAllocSize));
+
+        zoneAllocator.release(ptr);
+        REQUIRE(!page->hasZoneHeader());
+    }
+
+    SECTION("Allocate 128 bytes")
+    {
+        constexpr std::size_t cAllocSize = 128;
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+
+        auto* page = pageAllocator.getPage(std::uintptr_t(ptr));
+        REQUIRE(page);
+        REQUIRE(!page->hasZoneHeader());
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - 1);
+
+        auto stats = zoneAllocator.getStats();
+        REQUIRE(stats.usedMemorySize == 2 * cPageSize);
+        REQUIRE(stats.reservedMemorySize == detail::chunkSize(sizeof(Zone)));
+        REQUIRE(stats.allocatedMemorySize == detail::chunkSize(cAllocSize));
+
+        zoneAllocator.release(ptr);
+    }
+
+    SECTION("Allocate 128 bytes, when zone descriptors are exhausted")
+    {
+        constexpr std::size_t cAllocSize = 128;
+        std::size_t descCount = cPageSize / detail::chunkSize(sizeof(Zone));
+        std::size_t chunksPerZone = cPageSize / cAllocSize;
+        std::size_t allocCount = (descCount + 1) * chunksPerZone;
+
+        std::vector<void*> ptrs;
+        for (std::size_t i = 0; i < allocCount; ++i) {
+            auto* ptr = zoneAllocator.allocate(cAllocSize);
+            REQUIRE(ptr);
+            ptrs.push_back(ptr);
+        }
+
+        auto stats = zoneAllocator.getStats();
+        REQUIRE(stats.allocatedMemorySize == allocCount * cAllocSize);
+
+        for (auto* ptr : ptrs)
+            zoneAllocator.release(ptr);
+    }
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.reservedMemorySize == 0);
+    REQUIRE(stats.freeMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator tracks size class stats", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount> sizeClassStats{};
+    constexpr std::size_t cSizeClassesCount = 5;
+    REQUIRE(zoneAllocator.getSizeClassStats(sizeClassStats) == cSizeClassesCount);
+    for (std::size_t i = 0; i < cSizeClassesCount; ++i)
+        REQUIRE(sizeClassStats.at(i).chunkSize == ZoneAllocator::minimalAllocSize() << i);
+
+    constexpr std::size_t cAllocSize = 32;
+    constexpr std::size_t cAllocationsCount = 20;
+    constexpr std::size_t cReleasesCount = 5;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cAllocationsCount; ++i) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    for (std::size_t i = 0; i < cReleasesCount; ++i)
+        zoneAllocator.release(ptrs.at(i));
+
+    std::size_t chunksPerZone = (cPageSize - utils::alignUp(sizeof(Zone), cAllocSize)) / cAllocSize;
+    std::size_t zonesCount = (cAllocationsCount + chunksPerZone - 1) / chunksPerZone;
+    std::size_t freeChunksCount = zonesCount * chunksPerZone - (cAllocationsCount - cReleasesCount);
+
+    zoneAllocator.getSizeClassStats(sizeClassStats);
+    const auto& stats = sizeClassStats.at(detail::zoneIdx(cAllocSize));
+    REQUIRE(stats.zonesCount == zonesCount);
+    REQUIRE(stats.liveChunksCount == cAllocationsCount - cReleasesCount);
+    REQUIRE(stats.peakChunksCount == cAllocationsCount);
+    REQUIRE(stats.allocationsCount == cAllocationsCount);
+    REQUIRE(stats.releasesCount == cReleasesCount);
+    std::size_t reservedMemorySize = zonesCount * (cPageSize - chunksPerZone * cAllocSize);
+    REQUIRE(stats.wastedMemorySize == reservedMemorySize + freeChunksCount * cAllocSize);
+
+    auto zoneStats = zoneAllocator.getStats();
+    std::size_t wastedMemorySize = 0;
+    for (std::size_t i = 0; i < cSizeClassesCount; ++i)
+        wastedMemorySize += sizeClassStats.at(i).wastedMemorySize;
+
+    REQUIRE(wastedMemorySize == zoneStats.reservedMemorySize + zoneStats.freeMemorySize);
+}
+
+TEST_CASE("Zone allocator reuses partially used zones first", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    // Fill 100 zones completely.
+    constexpr std::size_t cAllocSize = 16;
+    constexpr std::size_t cZonesCount = 100;
+    std::size_t chunksPerZone = (cPageSize - utils::alignUp(sizeof(Zone), cAllocSize)) / cAllocSize;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cZonesCount * chunksPerZone; ++i) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cZonesCount);
+
+    SECTION("Chunk released in the first zone is reused")
+    {
+        auto* released = ptrs.front();
+        zoneAllocator.release(released);
+
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr == released);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cZonesCount);
+    }
+
+    SECTION("Chunk released in the middle zone is reused")
+    {
+        auto* released = ptrs.at(ptrs.size() / 2);
+        zoneAllocator.release(released);
+
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr == released);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cZonesCount);
+    }
+
+    SECTION("New zone is allocated only when all zones are full")
+    {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cZonesCount - 1);
+        zoneAllocator.release(ptr);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cZonesCount);
+    }
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+}
+
+TEST_CASE("Zone allocator selects zones according to the policy", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    // Fill 2 zones completely.
+    constexpr std::size_t cAllocSize = 16;
+    constexpr std::size_t cZonesCount = 2;
+    std::size_t chunksPerZone = (cPageSize - utils::alignUp(sizeof(Zone), cAllocSize)) / cAllocSize;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cZonesCount * chunksPerZone; ++i) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    // Leave the first zone almost full and the second one almost empty.
+    auto* fullerPage = pageAllocator.getPage(std::uintptr_t(ptrs.front()));
+    auto* emptierPage = pageAllocator.getPage(std::uintptr_t(ptrs.back()));
+    REQUIRE(fullerPage != emptierPage);
+
+    zoneAllocator.release(ptrs.front());
+    ptrs.erase(ptrs.begin());
+    for (std::size_t i = 0; i < chunksPerZone - 1; ++i) {
+        zoneAllocator.release(ptrs.back());
+        ptrs.pop_back();
+    }
+
+    SECTION("First fit policy")
+    {
+        zoneAllocator.setPolicy(ZonePolicy::eFirstFit);
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(pageAllocator.getPage(std::uintptr_t(ptr)) == emptierPage);
+        ptrs.push_back(ptr);
+    }
+
+    SECTION("Fullest first policy")
+    {
+        zoneAllocator.setPolicy(ZonePolicy::eFullestFirst);
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(pageAllocator.getPage(std::uintptr_t(ptr)) == fullerPage);
+        ptrs.push_back(ptr);
+    }
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator uses the first found zone by default", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    // Fill 2 zones completely.
+    constexpr std::size_t cAllocSize = 16;
+    constexpr std::size_t cZonesCount = 2;
+    std::size_t chunksPerZone = (cPageSize - utils::alignUp(sizeof(Zone), cAllocSize)) / cAllocSize;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cZonesCount * chunksPerZone; ++i) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    // Second zone is left almost empty first, then the first one almost full, so the fuller zone is found first.
+    auto* fullerPage = pageAllocator.getPage(std::uintptr_t(ptrs.front()));
+    auto* emptierPage = pageAllocator.getPage(std::uintptr_t(ptrs.back()));
+    REQUIRE(fullerPage != emptierPage);
+
+    for (std::size_t i = 0; i < chunksPerZone - 1; ++i) {
+        zoneAllocator.release(ptrs.back());
+        ptrs.pop_back();
+    }
+
+    zoneAllocator.release(ptrs.front());
+    ptrs.erase(ptrs.begin());
+
+    SECTION("Default policy")
+    {
+        // Allocator starts with the first fit policy.
+    }
+
+    SECTION("Policy is restored after using the fullest first one")
+    {
+        zoneAllocator.setPolicy(ZonePolicy::eFullestFirst);
+        zoneAllocator.setPolicy(ZonePolicy::eFirstFit);
+    }
+
+    // Found zone is used until it runs out of free chunks, regardless of the occupancy of the other zones.
+    for (std::size_t i = 0; i < 2; ++i) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(pageAllocator.getPage(std::uintptr_t(ptr)) == (i == 0 ? fullerPage : emptierPage));
+        ptrs.push_back(ptr);
+    }
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator colours new zones", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    std::size_t allocSize = 0;
+    bool colouring = false;
+
+    SECTION("Colouring is disabled, 16 bytes")
+    {
+        allocSize = 16;
+        colouring = false;
+    }
+
+    SECTION("Colouring is enabled, 16 bytes")
+    {
+        allocSize = 16;
+        colouring = true;
+    }
+
+    SECTION("Colouring is enabled, 512 bytes")
+    {
+        allocSize = 512;
+        colouring = true;
+    }
+
+    zoneAllocator.setColouring(colouring);
+
+    // Fill several zones completely and find the lowest chunk address in each of them.
+    constexpr std::size_t cZonesCount = 4;
+    std::vector<void*> ptrs;
+    std::map<std::uintptr_t, std::uintptr_t> firstChunks;
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+    while (pageAllocator.getStats().freePagesCount + cZonesCount + 1 != freePagesCount) {
+        auto* ptr = zoneAllocator.allocate(allocSize);
+        REQUIRE(ptr);
+        REQUIRE(std::uintptr_t(ptr) % allocSize == 0);
+        ptrs.push_back(ptr);
+
+        auto pageAddr = std::uintptr_t(ptr) & ~(cPageSize - 1);
+        auto it = firstChunks.find(pageAddr);
+        if (it == firstChunks.end() || it->second > std::uintptr_t(ptr))
+            firstChunks[pageAddr] = std::uintptr_t(ptr);
+    }
+
+    // Zones are filled one after another, so offsets are collected in the order of zones creation.
+    std::vector<std::size_t> offsets;
+    std::uintptr_t prevPageAddr = 0;
+    for (auto* ptr : ptrs) {
+        auto pageAddr = std::uintptr_t(ptr) & ~(cPageSize - 1);
+        if (pageAddr != prevPageAddr)
+            offsets.push_back(firstChunks[pageAddr] - pageAddr);
+
+        prevPageAddr = pageAddr;
+    }
+
+    REQUIRE(offsets.size() == cZonesCount + 1);
+    for (std::size_t i = 1; i < cZonesCount; ++i) {
+        if (colouring)
+            REQUIRE(offsets.at(i) != offsets.at(i - 1));
+        else
+            REQUIRE(offsets.at(i) == offsets.at(i - 1));
+    }
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.allocatedMemorySize == ptrs.size() * detail::chunkSize(allocSize));
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator grows the page batches of size classes that run dry", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 128;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    constexpr std::size_t cAllocSize = 16;
+    constexpr std::size_t cZonesCount = 16;
+    std::size_t maxPagesCount = 0;
+    std::size_t expectedRequestsCount = 0;
+    std::size_t expectedSparePagesCount = 0;
+
+    SECTION("Growth is disabled")
+    {
+        maxPagesCount = 1;
+        expectedRequestsCount = cZonesCount;
+        expectedSparePagesCount = 0;
+    }
+
+    SECTION("Growth is limited to 8 pages")
+    {
+        // Batches of 1, 2, 4, 8 and 8 pages.
+        maxPagesCount = 8;
+        expectedRequestsCount = 5;
+        expectedSparePagesCount = 7;
+    }
+
+    zoneAllocator.setGrowth(maxPagesCount);
+
+    std::array<allocator::TierStats, cTiersCount> tierStats{};
+    pageAllocator.getTierStats(tierStats);
+    auto requestsCount = tierStats.at(std::size_t(Tier::eFast)).requestsCount;
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount> sizeClassStats{};
+    const auto& stats = sizeClassStats.at(detail::zoneIdx(cAllocSize));
+
+    std::vector<void*> ptrs;
+    for (zoneAllocator.getSizeClassStats(sizeClassStats); stats.zonesCount < cZonesCount;
+         zoneAllocator.getSizeClassStats(sizeClassStats)) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    pageAllocator.getTierStats(tierStats);
+    REQUIRE(tierStats.at(std::size_t(Tier::eFast)).requestsCount - requestsCount == expectedRequestsCount);
+    REQUIRE(stats.sparePagesCount == expectedSparePagesCount);
+    REQUIRE(freePagesCount - pageAllocator.getStats().freePagesCount == cZonesCount + expectedSparePagesCount);
+    REQUIRE(zoneAllocator.getStats().allocatedMemorySize == ptrs.size() * cAllocSize);
+
+    // Releasing a whole batch of zones halves the batch, so idle size classes give their spare pages back.
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    zoneAllocator.getSizeClassStats(sizeClassStats);
+    REQUIRE(stats.sparePagesCount == 0);
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    REQUIRE(zoneAllocator.getStats().usedMemorySize == cPageSize);
+}
+
+TEST_CASE("Zone allocator keeps the page batches of size classes with steady churn", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 128;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    constexpr std::size_t cMaxPagesCount = 8;
+    zoneAllocator.setGrowth(cMaxPagesCount);
+
+    constexpr std::size_t cAllocSize = 16;
+    constexpr std::size_t cZonesCount = 16;
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount> sizeClassStats{};
+    const auto& stats = sizeClassStats.at(detail::zoneIdx(cAllocSize));
+
+    std::vector<void*> ptrs;
+    for (zoneAllocator.getSizeClassStats(sizeClassStats); stats.zonesCount < cZonesCount;
+         zoneAllocator.getSizeClassStats(sizeClassStats)) {
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        ptrs.push_back(ptr);
+    }
+
+    std::array<allocator::TierStats, cTiersCount> tierStats{};
+    pageAllocator.getTierStats(tierStats);
+    auto requestsCount = tierStats.at(std::size_t(Tier::eFast)).requestsCount;
+
+    // Each cycle releases the last zone and creates it again, so the spare pages are used and the batch is kept.
+    constexpr std::size_t cCyclesCount = 20;
+    for (std::size_t i = 0; i < cCyclesCount; ++i) {
+        auto lastPage = std::uintptr_t(ptrs.back()) & ~(cPageSize - 1);
+        std::size_t count = 0;
+        for (; !ptrs.empty() && (std::uintptr_t(ptrs.back()) & ~(cPageSize - 1)) == lastPage; ++count) {
+            zoneAllocator.release(ptrs.back());
+            ptrs.pop_back();
+        }
+
+        for (std::size_t j = 0; j < count; ++j) {
+            auto* ptr = zoneAllocator.allocate(cAllocSize);
+            REQUIRE(ptr);
+            ptrs.push_back(ptr);
+        }
+    }
+
+    // Batches of 8 pages serve 7 cycles each from their spare pages.
+    pageAllocator.getTierStats(tierStats);
+    REQUIRE(tierStats.at(std::size_t(Tier::eFast)).requestsCount - requestsCount == 2);
+
+    zoneAllocator.getSizeClassStats(sizeClassStats);
+    REQUIRE(stats.zonesCount == cZonesCount);
+    REQUIRE(stats.sparePagesCount != 0);
+}
+
 TEST_CASE("Zone allocator properly releases user memory", "[unit][ZoneAllocator]")
 {
     constexpr std::size_t cPageSize = 256;
@@ -493,4 +1104,142 @@ TEST_CASE("Zone allocator properly releases user memory", "[unit][ZoneAllocator]
     REQUIRE(stats.allocatedMemorySize == 0);
 }
 
+TEST_CASE("Zone allocator keeps pinned zones for reserved allocations", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount> sizeClassStats{};
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    REQUIRE(!zoneAllocator.reserve(0, 1));
+    REQUIRE(!zoneAllocator.reserve(cPageSize, 1));
+    REQUIRE(zoneAllocator.allocateReserved(32) == nullptr);
+
+    SECTION("Failed reservations don't pin any zones")
+    {
+        // Bigger chunks use off-page headers, so their descriptors have to be rolled back too.
+        for (std::size_t allocSize : {32, 128}) {
+            REQUIRE(!zoneAllocator.reserve(allocSize, cPagesCount * cPageSize / allocSize));
+            REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+
+            zoneAllocator.getSizeClassStats(sizeClassStats);
+            const auto& stats = sizeClassStats.at(detail::zoneIdx(allocSize));
+            REQUIRE(stats.zonesCount == 0);
+            REQUIRE(stats.reservedChunksCount == 0);
+            REQUIRE(stats.pinnedChunksCount == 0);
+        }
+    }
+
+    SECTION("Reserved chunks are not used by other allocations")
+    {
+        constexpr std::size_t cAllocSize = 128;
+        constexpr std::size_t cReservedCount = 5;
+        REQUIRE(zoneAllocator.reserve(cAllocSize, cReservedCount - 2));
+        REQUIRE(zoneAllocator.reserve(cAllocSize, 2));
+        REQUIRE(zoneAllocator.reserve(cAllocSize, 0));
+
+        zoneAllocator.getSizeClassStats(sizeClassStats);
+        const auto& stats = sizeClassStats.at(detail::zoneIdx(cAllocSize));
+        REQUIRE(stats.reservedChunksCount == cReservedCount);
+        REQUIRE(stats.pinnedChunksCount >= cReservedCount);
+        REQUIRE(stats.liveChunksCount == 0);
+        auto pinnedChunksCount = stats.pinnedChunksCount;
+        auto pinnedZonesCount = stats.zonesCount;
+
+        std::vector<void*> ptrs;
+        for (auto* ptr = zoneAllocator.allocate(cAllocSize); ptr != nullptr; ptr = zoneAllocator.allocate(cAllocSize))
+            ptrs.push_back(ptr);
+
+        REQUIRE(pageAllocator.getStats().freePagesCount == 0);
+
+        std::vector<void*> reservedPtrs;
+        for (std::size_t i = 0; i < pinnedChunksCount; ++i) {
+            auto* ptr = zoneAllocator.allocateReserved(cAllocSize - 1);
+            REQUIRE(ptr);
+            reservedPtrs.push_back(ptr);
+        }
+
+        REQUIRE(zoneAllocator.allocateReserved(cAllocSize) == nullptr);
+        REQUIRE(zoneAllocator.allocate(cAllocSize) == nullptr);
+
+        for (auto* ptr : reservedPtrs) {
+            std::memset(ptr, 0xa5, cAllocSize);
+            REQUIRE(std::find(ptrs.begin(), ptrs.end(), ptr) == ptrs.end());
+        }
+
+        for (auto* ptr : reservedPtrs)
+            zoneAllocator.release(ptr);
+
+        for (auto* ptr : ptrs)
+            zoneAllocator.release(ptr);
+
+        zoneAllocator.getSizeClassStats(sizeClassStats);
+        REQUIRE(stats.zonesCount == pinnedZonesCount);
+        REQUIRE(stats.pinnedChunksCount == pinnedChunksCount);
+        REQUIRE(stats.liveChunksCount == 0);
+        REQUIRE(zoneAllocator.allocateReserved(cAllocSize));
+    }
+}
+
+TEST_CASE("Zone allocator serves tiny blocks from the minimal size class", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {{{std::uintptr_t(memory.get()), size}, {0, 0}}};
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    constexpr std::size_t cAllocationsCount = 100;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < cAllocationsCount; ++i) {
+        auto* ptr = zoneAllocator.allocate(1 + i % ZoneAllocator::minimalAllocSize());
+        REQUIRE(ptr);
+        REQUIRE(std::uintptr_t(ptr) % ZoneAllocator::minimalAllocSize() == 0);
+        std::memset(ptr, int(i), ZoneAllocator::minimalAllocSize());
+        ptrs.push_back(ptr);
+    }
+
+    std::sort(ptrs.begin(), ptrs.end());
+    for (std::size_t i = 1; i < ptrs.size(); ++i)
+        REQUIRE(std::uintptr_t(ptrs.at(i)) - std::uintptr_t(ptrs.at(i - 1)) >= ZoneAllocator::minimalAllocSize());
+
+    std::array<allocator::SizeClassStats, allocator::cMaxSizeClassesCount> sizeClassStats{};
+    zoneAllocator.getSizeClassStats(sizeClassStats);
+    const auto& stats = sizeClassStats.at(0);
+    REQUIRE(stats.chunkSize == ZoneAllocator::minimalAllocSize());
+    REQUIRE(stats.liveChunksCount == cAllocationsCount);
+
+    auto chunksPerZone = (cPageSize - utils::alignUp(sizeof(Zone), stats.chunkSize)) / stats.chunkSize;
+    REQUIRE(stats.zonesCount == (cAllocationsCount + chunksPerZone - 1) / chunksPerZone);
+
+    for (auto* ptr : ptrs)
+        zoneAllocator.release(ptr);
+
+    zoneAllocator.getSizeClassStats(sizeClassStats);
+    REQUIRE(stats.zonesCount == 0);
+    REQUIRE(stats.liveChunksCount == 0);
+}
+
 } // namespace memory
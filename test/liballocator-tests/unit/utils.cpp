@@ -70,6 +70,21 @@ TEST_CASE("Values are correctly rounded to the closest power of 2", "[unit][util
     }
 }
 
+TEST_CASE("Values are correctly aligned up to the given alignment", "[unit][utils]")
+{
+    constexpr std::size_t cMaxAlignment = 4096;
+    constexpr std::size_t cIterations = 10000;
+
+    for (std::size_t alignment = 1; alignment <= cMaxAlignment; alignment *= 2) {
+        for (std::size_t i = 0; i < cIterations; ++i) {
+            auto value = utils::alignUp(i, alignment);
+            REQUIRE(value >= i);
+            REQUIRE(value - i < alignment);
+            REQUIRE(value % alignment == 0);
+        }
+    }
+}
+
 TEST_CASE("Pointers are correctly moved", "[unit][utils]")
 {
     constexpr int cMemorySize = 64;